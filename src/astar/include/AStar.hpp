@@ -10,6 +10,8 @@
 #include <functional>
 #include <set>
 #include <cmath>
+#include <chrono>
+#include <cstdint>
 
 namespace AStar
 {
@@ -23,6 +25,12 @@ namespace AStar
     using uint = unsigned int;
     using HeuristicFunction = std::function<uint(Vec2i, Vec2i)>;
     using CoordinateList = std::vector<Vec2i>;
+    // Row-major cell buffer (index = y * width + x) using the nav_msgs/OccupancyGrid
+    // convention: 0 is free, anything else (occupied or unknown) blocks the search.
+    using CollisionMap = std::vector<std::int8_t>;
+    // Row-major extra cost of entering each cell, in the same x10 scale as the
+    // moves, e.g. to keep paths away from walls.
+    using CostMap = std::vector<uint>;
 
     struct Node
     {
@@ -39,24 +47,71 @@ namespace AStar
     class Generator
     {
         bool detectCollision(Vec2i coordinates_);
+        bool detectCollisionAlong(Vec2i source_, Vec2i delta_);
+        std::size_t cellIndex(Vec2i coordinates_) const;
         Node* findNodeOnList(NodeSet& nodes_, Vec2i coordinates_);
         void releaseNodes(NodeSet& nodes_);
 
     public:
         Generator();
+        ~Generator();
+        Generator(const Generator&) = delete;
+        Generator& operator = (const Generator&) = delete;
+
         void setWorldSize(Vec2i worldSize_);
+        // Resizes the world and takes over map_ as its collision buffer in one
+        // go, without first allocating an empty one. map_ receives the previous
+        // buffer and must hold worldSize_.x * worldSize_.y cells.
+        void setWorldSize(Vec2i worldSize_, CollisionMap& map_);
         void setDiagonalMovement(bool enable_);
+        // Number of neighbours expanded per node: 4, 8, 16 or 32. Diagonal moves and
+        // moves that skip over cells are only allowed if every cell the segment
+        // touches is free, so no move cuts between two blocked corners.
+        void setNeighbourhood(uint size_);
         void setHeuristic(HeuristicFunction heuristic_);
         CoordinateList findPath(Vec2i source_, Vec2i target_);
         void addCollision(Vec2i coordinates_);
         void removeCollision(Vec2i coordinates_);
         void clearCollisions();
+        // True if every cell the segment between the two cell centers passes
+        // through is free, with the same test the search uses for long moves.
+        bool isSegmentFree(Vec2i source_, Vec2i target_);
+
+        // Direct access to the collision buffer, e.g. to publish it or to fill
+        // it from an external map without going through addCollision().
+        const CollisionMap& getCollisionMap() const;
+        // Exchanges the buffers without copying. The incoming map must hold
+        // worldSize.x * worldSize.y cells; out of range cells count as blocked.
+        void swapCollisionMap(CollisionMap& map_);
+        // Exchanges the cost buffers without copying. The incoming map must be
+        // empty or hold worldSize.x * worldSize.y cells; setWorldSize() clears it.
+        const CostMap& getCostMap() const;
+        void swapCostMap(CostMap& costs_);
+
+        // Resumable search: start() a query, call step() until it returns true,
+        // then collect the path with result(). A budget of 0 runs to completion.
+        void start(Vec2i source_, Vec2i target_);
+        bool step(uint budgetUs_ = 0);
+        bool isRunning() const;
+        bool isFound() const;
+        CoordinateList result();
+        void cancel();
 
     private:
+        bool expand();
+
         HeuristicFunction heuristic;
-        CoordinateList direction, walls;
+        CoordinateList direction;
+        std::vector<uint> directionCost;
+        CollisionMap walls;
+        CostMap costs;
         Vec2i worldSize;
         uint directions;
+
+        NodeSet openSet, closedSet;
+        Node *current;
+        Vec2i target;
+        bool running, found;
     };
 
     class Heuristic
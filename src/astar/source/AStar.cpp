@@ -26,23 +26,61 @@ AStar::uint AStar::Node::getScore()
 }
 
 AStar::Generator::Generator()
+    : worldSize({ 0, 0 }), current(nullptr), target({ 0, 0 }), running(false), found(false)
 {
     setDiagonalMovement(false);
     setHeuristic(&Heuristic::manhattan);
     direction = {
         { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
-        { -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 }
+        { -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 },
+        { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 },
+        { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 },
+        { 1, 3 }, { 3, 1 }, { 3, -1 }, { 1, -3 },
+        { -1, -3 }, { -3, -1 }, { -3, 1 }, { -1, 3 },
+        { 2, 3 }, { 3, 2 }, { 3, -2 }, { 2, -3 },
+        { -2, -3 }, { -3, -2 }, { -3, 2 }, { -2, 3 }
     };
+    // Euclidean length of each move, in the same x10 scale as the heuristics.
+    for (auto& move : direction) {
+        directionCost.push_back(static_cast<uint>(std::lround(10.0 * std::hypot(move.x, move.y))));
+    }
+}
+
+AStar::Generator::~Generator()
+{
+    cancel();
 }
 
 void AStar::Generator::setWorldSize(Vec2i worldSize_)
 {
     worldSize = worldSize_;
+    walls.assign(static_cast<std::size_t>(worldSize.x) * static_cast<std::size_t>(worldSize.y), 0);
+    costs.clear();
+}
+
+void AStar::Generator::setWorldSize(Vec2i worldSize_, CollisionMap& map_)
+{
+    worldSize = worldSize_;
+    walls.swap(map_);
+    costs.clear();
 }
 
 void AStar::Generator::setDiagonalMovement(bool enable_)
 {
-    directions = (enable_ ? 8 : 4);
+    setNeighbourhood(enable_ ? 8 : 4);
+}
+
+void AStar::Generator::setNeighbourhood(uint size_)
+{
+    if (size_ >= 32) {
+        directions = 32;
+    }
+    else if (size_ >= 16) {
+        directions = 16;
+    }
+    else {
+        directions = (size_ >= 8 ? 8 : 4);
+    }
 }
 
 void AStar::Generator::setHeuristic(HeuristicFunction heuristic_)
@@ -52,76 +90,167 @@ void AStar::Generator::setHeuristic(HeuristicFunction heuristic_)
 
 void AStar::Generator::addCollision(Vec2i coordinates_)
 {
-    walls.push_back(coordinates_);
+    std::size_t index = cellIndex(coordinates_);
+    if (index < walls.size()) {
+        walls[index] = 100;
+    }
 }
 
 void AStar::Generator::removeCollision(Vec2i coordinates_)
 {
-    auto it = std::find(walls.begin(), walls.end(), coordinates_);
-    if (it != walls.end()) {
-        walls.erase(it);
+    std::size_t index = cellIndex(coordinates_);
+    if (index < walls.size()) {
+        walls[index] = 0;
     }
 }
 
 void AStar::Generator::clearCollisions()
 {
-    walls.clear();
+    std::fill(walls.begin(), walls.end(), 0);
+}
+
+bool AStar::Generator::isSegmentFree(Vec2i source_, Vec2i target_)
+{
+    return !detectCollision(source_) && !detectCollision(target_) &&
+           !detectCollisionAlong(source_, { target_.x - source_.x, target_.y - source_.y });
+}
+
+const AStar::CollisionMap& AStar::Generator::getCollisionMap() const
+{
+    return walls;
+}
+
+void AStar::Generator::swapCollisionMap(CollisionMap& map_)
+{
+    walls.swap(map_);
+}
+
+const AStar::CostMap& AStar::Generator::getCostMap() const
+{
+    return costs;
+}
+
+void AStar::Generator::swapCostMap(CostMap& costs_)
+{
+    costs.swap(costs_);
 }
 
 AStar::CoordinateList AStar::Generator::findPath(Vec2i source_, Vec2i target_)
 {
-    Node *current = nullptr;
-    NodeSet openSet, closedSet;
-    openSet.insert(new Node(source_));
+    start(source_, target_);
+    step();
+    return result();
+}
 
-    while (!openSet.empty()) {
-        current = *openSet.begin();
-        for (auto node : openSet) {
-            if (node->getScore() <= current->getScore()) {
-                current = node;
-            }
-        }
+void AStar::Generator::start(Vec2i source_, Vec2i target_)
+{
+    cancel();
+    target = target_;
+    current = new Node(source_);
+    openSet.insert(current);
+    running = true;
+}
+
+bool AStar::Generator::step(uint budgetUs_)
+{
+    if (!running) {
+        return true;
+    }
 
-        if (current->coordinates == target_) {
+    // Reading the clock costs more than expanding a node, so only poll it
+    // every few expansions.
+    const uint pollInterval = 64;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(budgetUs_);
+    for (uint expanded = 1; running; ++expanded) {
+        running = expand();
+        if (budgetUs_ > 0 && expanded % pollInterval == 0 &&
+            std::chrono::steady_clock::now() >= deadline) {
             break;
         }
+    }
+    return !running;
+}
+
+bool AStar::Generator::expand()
+{
+    if (openSet.empty()) {
+        return false;
+    }
+
+    current = *openSet.begin();
+    for (auto node : openSet) {
+        if (node->getScore() <= current->getScore()) {
+            current = node;
+        }
+    }
 
-        closedSet.insert(current);
-        openSet.erase(std::find(openSet.begin(), openSet.end(), current));
+    if (current->coordinates == target) {
+        found = true;
+        return false;
+    }
 
-        for (uint i = 0; i < directions; ++i) {
-            Vec2i newCoordinates(current->coordinates + direction[i]);
-            if (detectCollision(newCoordinates) ||
-                findNodeOnList(closedSet, newCoordinates)) {
-                continue;
-            }
+    closedSet.insert(current);
+    openSet.erase(std::find(openSet.begin(), openSet.end(), current));
 
-            uint totalCost = current->G + ((i < 4) ? 10 : 14);
+    for (uint i = 0; i < directions; ++i) {
+        Vec2i newCoordinates(current->coordinates + direction[i]);
+        if (detectCollision(newCoordinates) ||
+            (i >= 4 && detectCollisionAlong(current->coordinates, direction[i])) ||
+            findNodeOnList(closedSet, newCoordinates)) {
+            continue;
+        }
 
-            Node *successor = findNodeOnList(openSet, newCoordinates);
-            if (successor == nullptr) {
-                successor = new Node(newCoordinates, current);
-                successor->G = totalCost;
-                successor->H = heuristic(successor->coordinates, target_);
-                openSet.insert(successor);
-            }
-            else if (totalCost < successor->G) {
-                successor->parent = current;
-                successor->G = totalCost;
-            }
+        uint totalCost = current->G + directionCost[i];
+        if (!costs.empty()) {
+            totalCost += costs[cellIndex(newCoordinates)];
+        }
+
+        Node *successor = findNodeOnList(openSet, newCoordinates);
+        if (successor == nullptr) {
+            successor = new Node(newCoordinates, current);
+            successor->G = totalCost;
+            successor->H = heuristic(successor->coordinates, target);
+            openSet.insert(successor);
+        }
+        else if (totalCost < successor->G) {
+            successor->parent = current;
+            successor->G = totalCost;
         }
     }
+    return true;
+}
+
+bool AStar::Generator::isRunning() const
+{
+    return running;
+}
 
+bool AStar::Generator::isFound() const
+{
+    return found;
+}
+
+AStar::CoordinateList AStar::Generator::result()
+{
+    // Like findPath, an exhausted search returns the path to the last node it
+    // expanded rather than an empty list.
     CoordinateList path;
     while (current != nullptr) {
         path.push_back(current->coordinates);
         current = current->parent;
     }
 
+    cancel();
+    return path;
+}
+
+void AStar::Generator::cancel()
+{
     releaseNodes(openSet);
     releaseNodes(closedSet);
-
-    return path;
+    current = nullptr;
+    running = false;
+    found = false;
 }
 
 AStar::Node* AStar::Generator::findNodeOnList(NodeSet& nodes_, Vec2i coordinates_)
@@ -144,14 +273,56 @@ void AStar::Generator::releaseNodes(NodeSet& nodes_)
 
 bool AStar::Generator::detectCollision(Vec2i coordinates_)
 {
-    if (coordinates_.x < 0 || coordinates_.x >= worldSize.x ||
-        coordinates_.y < 0 || coordinates_.y >= worldSize.y ||
-        std::find(walls.begin(), walls.end(), coordinates_) != walls.end()) {
-        return true;
+    std::size_t index = cellIndex(coordinates_);
+    return index >= walls.size() || walls[index] != 0;
+}
+
+bool AStar::Generator::detectCollisionAlong(Vec2i source_, Vec2i delta_)
+{
+    // Supercover traversal of the segment between the two cell centers: every
+    // cell it passes through is checked, and both side cells when it crosses a
+    // corner exactly. The end cell is left to detectCollision().
+    int dx = std::abs(delta_.x), dy = std::abs(delta_.y);
+    int sx = (delta_.x > 0) ? 1 : -1, sy = (delta_.y > 0) ? 1 : -1;
+    Vec2i cell = source_;
+    for (int ix = 0, iy = 0; ix + iy < dx + dy - 1;) {
+        // Compare where the segment leaves the cell in x and in y.
+        int leaveX = (1 + 2 * ix) * dy, leaveY = (1 + 2 * iy) * dx;
+        if (leaveX == leaveY) {
+            if (detectCollision({ cell.x + sx, cell.y }) ||
+                detectCollision({ cell.x, cell.y + sy })) {
+                return true;
+            }
+            cell.x += sx;
+            cell.y += sy;
+            ++ix;
+            ++iy;
+        }
+        else if (leaveX < leaveY) {
+            cell.x += sx;
+            ++ix;
+        }
+        else {
+            cell.y += sy;
+            ++iy;
+        }
+        if (detectCollision(cell)) {
+            return true;
+        }
     }
     return false;
 }
 
+std::size_t AStar::Generator::cellIndex(Vec2i coordinates_) const
+{
+    if (coordinates_.x < 0 || coordinates_.x >= worldSize.x ||
+        coordinates_.y < 0 || coordinates_.y >= worldSize.y) {
+        return walls.size();
+    }
+    return static_cast<std::size_t>(coordinates_.y) * static_cast<std::size_t>(worldSize.x) +
+           static_cast<std::size_t>(coordinates_.x);
+}
+
 AStar::Vec2i AStar::Heuristic::getDelta(Vec2i source_, Vec2i target_)
 {
     return{ abs(source_.x - target_.x),  abs(source_.y - target_.y) };
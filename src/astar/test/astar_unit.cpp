@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <AStar.hpp>
+
+#include <cstdlib>
+
+namespace
+{
+    // A wall across the middle of the world with a gap at the top, so the
+    // search has to expand most of the world to get around it.
+    void buildWall(AStar::Generator& generator_, int size_)
+    {
+        generator_.setWorldSize({ size_, size_ });
+        for (int y = 0; y < size_ - 1; ++y) {
+            generator_.addCollision({ size_ / 2, y });
+        }
+    }
+
+    // True if consecutive cells of the path are one move of the 4-neighbourhood apart.
+    bool isConnected(const AStar::CoordinateList& path_)
+    {
+        for (std::size_t i = 1; i < path_.size(); ++i) {
+            if (std::abs(path_[i].x - path_[i - 1].x) + std::abs(path_[i].y - path_[i - 1].y) != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST(GeneratorStep, BudgetSlicesTheSearch)
+{
+    AStar::Generator generator;
+    buildWall(generator, 60);
+
+    AStar::CoordinateList reference = generator.findPath({ 0, 0 }, { 59, 0 });
+    ASSERT_FALSE(reference.empty());
+
+    // a budget far below the search time stops at the first clock poll
+    generator.start({ 0, 0 }, { 59, 0 });
+    EXPECT_FALSE(generator.step(1));
+    EXPECT_TRUE(generator.isRunning());
+    EXPECT_FALSE(generator.isFound());
+
+    int slices = 1;
+    while (!generator.step(1)) {
+        ++slices;
+    }
+    EXPECT_GT(slices, 1);
+    EXPECT_FALSE(generator.isRunning());
+    EXPECT_TRUE(generator.isFound());
+
+    // sliced or not, the search finds a path of the same length
+    AStar::CoordinateList path = generator.result();
+    EXPECT_EQ(path.size(), reference.size());
+    EXPECT_TRUE(isConnected(path));
+    EXPECT_TRUE(path.front() == AStar::Vec2i({ 59, 0 }));
+    EXPECT_TRUE(path.back() == AStar::Vec2i({ 0, 0 }));
+}
+
+TEST(GeneratorStep, ZeroBudgetRunsToCompletion)
+{
+    AStar::Generator generator;
+    buildWall(generator, 60);
+
+    generator.start({ 0, 0 }, { 59, 0 });
+    EXPECT_TRUE(generator.step(0));
+    EXPECT_TRUE(generator.isFound());
+
+    // a finished search stays finished until the next start()
+    EXPECT_TRUE(generator.step(1));
+    EXPECT_TRUE(isConnected(generator.result()));
+}
+
+TEST(GeneratorStep, CancelStopsTheSearch)
+{
+    AStar::Generator generator;
+    buildWall(generator, 60);
+
+    generator.start({ 0, 0 }, { 59, 0 });
+    EXPECT_FALSE(generator.step(1));
+    generator.cancel();
+    EXPECT_FALSE(generator.isRunning());
+    EXPECT_FALSE(generator.isFound());
+    EXPECT_TRUE(generator.step(1));
+    EXPECT_TRUE(generator.result().empty());
+}
+
+TEST(GeneratorStep, UnreachableTargetEndsNotFound)
+{
+    AStar::Generator generator;
+    buildWall(generator, 20);
+    generator.addCollision({ 10, 19 });
+
+    generator.start({ 0, 0 }, { 19, 0 });
+    while (!generator.step(1)) {
+    }
+    EXPECT_FALSE(generator.isFound());
+}
+
+TEST(SegmentFree, SupercoverChecksEveryCellCrossed)
+{
+    AStar::Generator generator;
+    generator.setWorldSize({ 5, 5 });
+
+    // from (0, 0) to (2, 1) the segment crosses (1, 0) and (1, 1), but not (0, 1) or (2, 0)
+    EXPECT_TRUE(generator.isSegmentFree({ 0, 0 }, { 2, 1 }));
+    generator.addCollision({ 0, 1 });
+    generator.addCollision({ 2, 0 });
+    EXPECT_TRUE(generator.isSegmentFree({ 0, 0 }, { 2, 1 }));
+    EXPECT_TRUE(generator.isSegmentFree({ 2, 1 }, { 0, 0 }));
+
+    generator.addCollision({ 1, 1 });
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 2, 1 }));
+    EXPECT_FALSE(generator.isSegmentFree({ 2, 1 }, { 0, 0 }));
+
+    generator.clearCollisions();
+    generator.addCollision({ 1, 0 });
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 2, 1 }));
+}
+
+TEST(SegmentFree, ExactCornerBlocksOnEitherSide)
+{
+    AStar::Generator generator;
+    generator.setWorldSize({ 5, 5 });
+
+    // the diagonal passes exactly through the corners of the cells next to it
+    EXPECT_TRUE(generator.isSegmentFree({ 0, 0 }, { 2, 2 }));
+    generator.addCollision({ 1, 0 });
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 2, 2 }));
+
+    generator.clearCollisions();
+    generator.addCollision({ 1, 2 });
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 2, 2 }));
+
+    // cells away from the corners are not touched
+    generator.clearCollisions();
+    generator.addCollision({ 2, 0 });
+    generator.addCollision({ 0, 2 });
+    EXPECT_TRUE(generator.isSegmentFree({ 0, 0 }, { 2, 2 }));
+}
+
+TEST(SegmentFree, EndCellsAndWorldBounds)
+{
+    AStar::Generator generator;
+    generator.setWorldSize({ 5, 5 });
+
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 5, 1 }));
+    EXPECT_FALSE(generator.isSegmentFree({ -1, 0 }, { 2, 1 }));
+
+    generator.addCollision({ 3, 1 });
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 3, 1 }));
+    EXPECT_FALSE(generator.isSegmentFree({ 3, 1 }, { 0, 0 }));
+}
+
+TEST(CollisionMap, SetWorldSizeTakesOverTheBuffer)
+{
+    AStar::Generator generator;
+    generator.setWorldSize({ 4, 4 });
+
+    AStar::CollisionMap cells(3 * 2, 0);
+    cells[1] = 100;
+    const std::int8_t* data = cells.data();
+    generator.setWorldSize({ 3, 2 }, cells);
+
+    // the buffer is moved, not copied, and the previous one is handed back
+    EXPECT_EQ(generator.getCollisionMap().data(), data);
+    EXPECT_EQ(cells.size(), 16u);
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 2, 0 }));
+    EXPECT_TRUE(generator.isSegmentFree({ 0, 1 }, { 2, 1 }));
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 1 }, { 3, 1 }));
+}
+
+TEST(Neighbourhood, DiagonalMovesDoNotCutBlockedCorners)
+{
+    AStar::Generator generator;
+    generator.setWorldSize({ 2, 2 });
+    generator.setDiagonalMovement(true);
+
+    // the diagonal from (0, 0) to (1, 1) squeezes between (1, 0) and (0, 1)
+    generator.addCollision({ 1, 0 });
+    generator.addCollision({ 0, 1 });
+    EXPECT_FALSE(generator.isSegmentFree({ 0, 0 }, { 1, 1 }));
+    generator.start({ 0, 0 }, { 1, 1 });
+    EXPECT_TRUE(generator.step());
+    EXPECT_FALSE(generator.isFound());
+
+    // with one side free the search goes around the corner
+    generator.removeCollision({ 0, 1 });
+    AStar::CoordinateList path = generator.findPath({ 0, 0 }, { 1, 1 });
+    ASSERT_EQ(path.size(), 3u);
+    EXPECT_TRUE(path[1] == AStar::Vec2i({ 0, 1 }));
+
+    // with both free it takes the diagonal
+    generator.clearCollisions();
+    path = generator.findPath({ 0, 0 }, { 1, 1 });
+    EXPECT_EQ(path.size(), 2u);
+}
+
+TEST(Neighbourhood, LongMovesDoNotClipBlockedCells)
+{
+    AStar::Generator generator;
+    generator.setWorldSize({ 3, 2 });
+    generator.setHeuristic(&AStar::Heuristic::euclidean);
+    generator.setNeighbourhood(16);
+
+    // the knight move from (0, 0) to (2, 1) crosses (1, 0) and (1, 1), with both blocked there is no path
+    generator.addCollision({ 1, 0 });
+    generator.addCollision({ 1, 1 });
+    generator.start({ 0, 0 }, { 2, 1 });
+    EXPECT_TRUE(generator.step());
+    EXPECT_FALSE(generator.isFound());
+
+    // with one of them free the search has to step through it, and around the blocked corner
+    generator.removeCollision({ 1, 1 });
+    AStar::CoordinateList path = generator.findPath({ 0, 0 }, { 2, 1 });
+    ASSERT_EQ(path.size(), 4u);
+    EXPECT_TRUE(path[1] == AStar::Vec2i({ 1, 1 }));
+    EXPECT_TRUE(path[2] == AStar::Vec2i({ 0, 1 }));
+
+    // with both free it takes the knight move
+    generator.clearCollisions();
+    path = generator.findPath({ 0, 0 }, { 2, 1 });
+    EXPECT_EQ(path.size(), 2u);
+}
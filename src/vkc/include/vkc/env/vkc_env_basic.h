@@ -18,6 +18,12 @@ TESSERACT_COMMON_IGNORE_WARNINGS_POP
 #include <vkc/action/actions.h>
 #include <vkc/construct_vkc.h>
 #include <vkc/object/objects.h>
+#include <vkc/planner/base_roadmap.h>
+#include <vkc/planner/floor_geometry.h>
+#include <vkc/planner/joint_sweep_regions.h>
+#include <vkc/planner/planar_base_ur_inv_kin.h>
+#include <vkc/planner/static_base_layer.h>
+#include <vkc/planner/visibility_graph.h>
 
 #include <cmath>
 #include <iostream>
@@ -63,7 +69,34 @@ public:
   std::string updateEnv(std::vector<std::string>& joint_names, tesseract_motion_planners::PlannerResponse& response, ActionBase::Ptr action);
 
   std::string getEndEffectorLink();
-  
+
+  /**
+   * @brief Roadmap of the floor for base path queries, built on first use and brought up to date with the
+   * current state of the scene, i.e. attached objects and the joints of doors and drawers.
+   * @return nullptr if the environment did not set up its static base layer
+   */
+  BaseRoadmap::Ptr getBaseRoadmap();
+
+  /**
+   * @brief Visibility graph of the floor for base path queries, built on first use and rebuilt once objects are
+   * attached or detached, or the movable part of the scene moved.
+   * @return nullptr if the environment did not set up its static base layer, or the scene has obstacles the
+   * graph cannot represent, see VisibilityGraph::isComplete()
+   */
+  VisibilityGraph::Ptr getVisibilityGraph();
+
+  /**
+   * @brief Obstacles of the floor grid that no action can move.
+   * @return nullptr if the environment did not set it up
+   */
+  StaticBaseLayer::Ptr getStaticBaseLayer();
+
+  /**
+   * @brief Floor regions swept by the articulated parts of the scene objects.
+   * @return nullptr if the environment did not compute them
+   */
+  JointSweepRegions::ConstPtr getJointSweepRegions();
+
 
 protected:
   ros::NodeHandle nh_;
@@ -80,6 +113,12 @@ protected:
   std::string robot_end_effector_link_;
   std::unordered_map<std::string, vkc::BaseObject::AttachLocation::Ptr> attach_locations_;
   std::vector<std::string> attached_links_;
+  BaseRoadmap::Ptr base_roadmap_;                     /**< @brief Base roadmap over the current scene */
+  VisibilityGraph::Ptr visibility_graph_;             /**< @brief Visibility graph over the current scene */
+  /** @brief Poses of the dynamic links of the static base layer the visibility graph was built with */
+  std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d>> visibility_graph_poses_;
+  StaticBaseLayer::Ptr static_base_layer_;            /**< @brief Static part of the base grid of the scene */
+  JointSweepRegions::Ptr joint_sweep_regions_;        /**< @brief Floor swept by the articulated parts of objects */
   /**
    * @brief Set initial pose to home pose for all groups as defined in SRDF file
    * @return False if no home pose is defined
@@ -116,6 +155,40 @@ protected:
 
   bool isGroupExist(std::string group_id);
 
+  /**
+   * @brief Make the closed form solver of a UR arm on a planar base the default inverse kinematics of the vkc
+   * group, in place of the numerical one. The arm is made of the six joints that move the robot end effector.
+   * The group keeps the numerical solver if its chain is not a UR arm on the planar base joints.
+   */
+  void registerBaseArmInvKin();
+
+  /**
+   * @brief Build the base roadmap over the scene in its current state, once the static base layer is set up.
+   * The dynamic links of the static base layer are the movable part of the scene, everything else is static.
+   * The roadmap covers the scene as found by fitMapInfo().
+   * @param step_size Spacing of the roadmap lattice
+   */
+  void initBaseRoadmap(double step_size = 0.25);
+
+  /**
+   * @brief Split the scene into the static and dynamic part of the base grid once it is set up.
+   * Objects that can be picked up and the articulated parts of fixed base objects are dynamic.
+   * The static part is rasterised, or mapped from the grid storage, when a map layout is first used.
+   */
+  void initStaticBaseLayer();
+
+  /** @brief Sample the floor regions swept by the articulated parts of the scene once it is set up. */
+  void initJointSweepRegions();
+
+  /** @brief Joints of the scene objects that move some of their links, e.g. door hinges and drawer slides. */
+  std::vector<std::string> getArticulatedJoints();
+
+  /**
+   * @brief The link of an attach location together with all links below it in the scene graph,
+   * i.e. the links that move when it is attached or detached.
+   */
+  std::vector<std::string> getAttachedSubtree(std::string attach_location_name);
+
   void attachObject(std::string attach_location_name, Eigen::Isometry3d* tf = nullptr);
 
   void detachObject(std::string attach_location_name);
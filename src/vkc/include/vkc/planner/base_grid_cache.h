@@ -0,0 +1,84 @@
+#ifndef VKC_BASE_GRID_CACHE_H
+#define VKC_BASE_GRID_CACHE_H
+
+#include <AStar.hpp>
+
+#include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/incremental_base_grid.h>
+#include <vkc/planner/map_info.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Keeps the most recently built base grids, so that retries and consecutive actions on an
+ * unchanged scene do not rebuild them.
+ *
+ * A grid only depends on the map layout, on which links belong to the robot and on the poses of all
+ * other links. The first two are covered by the map and the environment revision (attaching and
+ * detaching objects moves links and bumps the revision), the last one by a hash of the link poses.
+ * The robot itself may move freely without invalidating a grid.
+ * On a miss, an incrementally maintained grid of the same layout is brought up to date, which only
+ * rasterises again the links that moved since it was last used. Its static cells can outlive the process,
+ * see StaticBaseLayer::setStorageDirectory().
+ */
+class BaseGridCache
+{
+public:
+  struct Key
+  {
+    MapInfo map;
+    long revision;
+    std::size_t scene_hash;
+
+    bool operator==(const Key& other) const;
+  };
+
+  /** @param capacity Number of grids kept, the least recently used one is dropped first */
+  explicit BaseGridCache(std::size_t capacity = 4);
+
+  /** @brief Key of the base grid of the environment in its current state. */
+  static Key makeKey(VKCEnvBasic& env, const MapInfo& map);
+
+  /**
+   * @brief Load a cached grid into the A* generator.
+   * @return False if no grid is cached for the key, the generator is left untouched
+   */
+  bool lookup(const Key& key, AStar::Generator& astar_generator);
+
+  /**
+   * @brief Update the incremental grid of the map layout and load it into the A* generator.
+   * @return False if the scene cannot be rasterised, see IncrementalBaseGrid::update()
+   */
+  bool rasterise(VKCEnvBasic& env, const MapInfo& map, AStar::Generator& astar_generator);
+
+  /** @brief Cache the collision map of the A* generator, it must not contain search specific changes yet. */
+  void store(const Key& key, const AStar::Generator& astar_generator);
+
+  void clear();
+
+  std::size_t getHits() const;
+  std::size_t getMisses() const;
+
+private:
+  struct Entry
+  {
+    Key key;
+    AStar::CollisionMap cells;
+  };
+
+  std::size_t capacity_;
+  std::list<Entry> entries_; /**< @brief Most recently used first */
+  std::vector<IncrementalBaseGrid> grids_; /**< @brief One per map layout, oldest first */
+  std::size_t hits_;
+  std::size_t misses_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_BASE_GRID_CACHE_H
@@ -0,0 +1,116 @@
+#ifndef VKC_BASE_ROADMAP_H
+#define VKC_BASE_ROADMAP_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+#include <Eigen/StdVector>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract/tesseract.h>
+#include <tesseract_collision/core/discrete_contact_manager.h>
+
+#include <vkc/planner/map_info.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Sparse grid roadmap for the mobile base with lazily checked and cached edges.
+ *
+ * The roadmap is created once per scene. Nodes sit on a coarse lattice over the map and are joined to
+ * their 8 neighbours. Nothing is collision checked up front: nodes and edges are checked the first
+ * time a search reaches them and the result is kept for all later queries. Only links that can move
+ * (objects that can be attached to the robot, doors and drawers) invalidate the cache, and only for the
+ * edges whose swept footprint overlaps the floor area the link left or entered.
+ */
+class BaseRoadmap
+{
+public:
+  using Ptr = std::shared_ptr<BaseRoadmap>;
+  using Path = std::vector<Eigen::Vector2d, Eigen::aligned_allocator<Eigen::Vector2d>>;
+
+  /**
+   * @param map Area covered by the roadmap, step_size is the spacing between nodes
+   * @param check_resolution Distance between collision checks along an edge
+   */
+  BaseRoadmap(const MapInfo& map, double check_resolution = 0.05);
+
+  /**
+   * @brief Set up the roadmap for a scene in its current state, dropping any cached validity.
+   * Movable links that are part of the vkc kinematic chain at this point are taken as attached.
+   * @param movable_links Links that may later be moved through updateLinks() or update(), all other scene
+   * links are static
+   */
+  void build(tesseract::Tesseract::ConstPtr tesseract, const std::vector<std::string>& movable_links);
+
+  /**
+   * @brief Move the movable links that are obstacles to their current pose, e.g. after a door was opened.
+   * Only links whose floor bounds changed invalidate cached nodes and edges.
+   */
+  void update();
+
+  /**
+   * @brief Notify the roadmap that links have been attached to or detached from the robot.
+   * Links that are now part of the vkc kinematic chain stop being obstacles, all others are moved to
+   * their current pose. Cached nodes and edges around both the previous and the new pose are
+   * invalidated and will be checked again when a search reaches them.
+   * @param attached True if the links now move with the robot
+   */
+  void updateLinks(const std::vector<std::string>& link_names, bool attached);
+
+  /**
+   * @brief Shortest roadmap path between two floor positions.
+   * Start and goal are connected to nearby nodes with straight segments; the query points themselves are
+   * not checked, the same way the grid planner never blocks its own start and goal cells.
+   * @param path Waypoints from start to goal, including both
+   * @return False if the goal cannot be reached
+   */
+  bool findPath(const Eigen::Vector2d& start, const Eigen::Vector2d& goal, Path& path);
+
+  const MapInfo& getMapInfo() const;
+
+  /** @brief Number of collision checks done since build(), a measure of how much the cache saves. */
+  std::size_t getCheckCount() const;
+
+private:
+  enum class Validity : std::uint8_t
+  {
+    UNKNOWN,
+    VALID,
+    INVALID
+  };
+
+  std::size_t nodeIndex(int x, int y) const;
+  Eigen::Vector2d nodePosition(std::size_t node) const;
+  bool neighbour(std::size_t node, std::size_t dir, std::size_t& other) const;
+
+  bool isNodeValid(std::size_t node);
+  bool isEdgeValid(std::size_t node, std::size_t dir);
+  bool isFree(const Eigen::Vector2d& position);
+  bool isSegmentFree(const Eigen::Vector2d& from, const Eigen::Vector2d& to);
+
+  void invalidate(const Eigen::AlignedBox2d& bounds);
+
+  MapInfo map_;
+  double check_resolution_;
+  std::string base_link_name_;
+  tesseract_environment::Environment::ConstPtr env_;
+  tesseract_collision::DiscreteContactManager::Ptr contact_manager_;
+  Eigen::AlignedBox2d footprint_; /**< @brief Floor bounds of the base relative to its position */
+  std::unordered_map<std::string, Eigen::AlignedBox2d, std::hash<std::string>, std::equal_to<std::string>,
+                     Eigen::aligned_allocator<std::pair<const std::string, Eigen::AlignedBox2d>>>
+      movable_bounds_; /**< @brief Last known floor bounds of the movable links that are obstacles */
+  std::vector<Validity> nodes_;
+  std::vector<Validity> edges_; /**< @brief 8 per node, both directions of an edge are kept in sync */
+  std::size_t check_count_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_BASE_ROADMAP_H
@@ -0,0 +1,84 @@
+#ifndef VKC_FLOOR_DISTANCE_FIELD_H
+#define VKC_FLOOR_DISTANCE_FIELD_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <AStar.hpp>
+
+#include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/map_info.h>
+
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Euclidean distance from every floor cell to the nearest obstacle the base could hit.
+ *
+ * Obstacles are the collision shapes of the scene in the height range of the base, rasterised onto the
+ * map so that a cell is blocked if any part of it is covered. The distances are computed once with the
+ * linear time distance transform of Felzenszwalb and Huttenlocher, after which every clearance query
+ * is a single lookup. Distances are measured between cell centers, so the distance of an arbitrary
+ * floor point is only known up to getErrorBound().
+ */
+class FloorDistanceField
+{
+public:
+  FloorDistanceField();
+
+  /**
+   * @brief Rasterise the obstacles of the environment and compute their distance field.
+   * @return False if the scene has shapes that cannot be rasterised or the base has no geometry,
+   * the field is then left empty
+   */
+  bool build(VKCEnvBasic& env, const MapInfo& map);
+
+  /** @brief Compute the distance field of a row major grid, non zero cells are obstacles. */
+  void compute(const AStar::CollisionMap& cells, const MapInfo& map);
+
+  bool empty() const;
+  const MapInfo& getMapInfo() const;
+
+  /** @brief Distance from the cell center to the nearest blocked cell center, 0 on blocked cells and outside the map. */
+  double getDistance(int x, int y) const;
+
+  /** @brief Distance of the cell containing the point, see getErrorBound(). */
+  double getDistance(const Eigen::Vector2d& point) const;
+
+  /** @brief Largest difference between getDistance() of a point and its true distance to the obstacles. */
+  double getErrorBound() const;
+
+  /** @brief Radius of the largest circle inside the base footprint, known after build(). */
+  double getBaseInscribedRadius() const;
+
+  /** @brief Radius of the smallest circle around the base footprint, known after build(). */
+  double getBaseCircumscribedRadius() const;
+
+  /** @brief True if an obstacle certainly reaches into the base footprint at the point, whatever its heading. */
+  bool isBaseInCollision(const Eigen::Vector2d& point) const;
+
+  /**
+   * @brief Extra A* cost of entering each cell, to keep base paths away from walls.
+   * @param min_distance Cells up to this distance get the full weight
+   * @param max_distance Cells from this distance on are free of cost, in between the cost falls linearly
+   * @param weight Cost in the x10 scale of the A* moves, i.e. 10 doubles the cost of a straight step
+   */
+  void getClearanceCosts(double min_distance, double max_distance, AStar::uint weight, AStar::CostMap& costs) const;
+
+private:
+  /** @brief Squared distance transform of one row or column, see Felzenszwalb and Huttenlocher (2012). */
+  static void transform(const std::vector<double>& f, int n, std::vector<double>& d, std::vector<int>& v,
+                        std::vector<double>& z);
+
+  MapInfo map_;
+  std::vector<float> distance_; /**< @brief Row major, in meters */
+  double inscribed_radius_;
+  double circumscribed_radius_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_FLOOR_DISTANCE_FIELD_H
@@ -0,0 +1,97 @@
+#ifndef VKC_FLOOR_GEOMETRY_H
+#define VKC_FLOOR_GEOMETRY_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+#include <Eigen/StdVector>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract_environment/core/environment.h>
+
+#include <vkc/planner/map_info.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+using FloorPolygon = std::vector<Eigen::Vector2d, Eigen::aligned_allocator<Eigen::Vector2d>>;
+
+/**
+ * @brief Floor projection of one collision shape: the convex hull of its outline and its height range.
+ * Round shapes are replaced by circumscribed polygons and meshes by the hull of their vertices,
+ * so the projection never underestimates the shape.
+ */
+struct FloorShape
+{
+  FloorPolygon hull; /**< @brief Counter-clockwise, without collinear points */
+  double z_min;
+  double z_max;
+};
+
+/**
+ * @brief Convex hull of a set of floor points (Andrew's monotone chain).
+ * @return The hull counter-clockwise without collinear points
+ */
+FloorPolygon convexHull(FloorPolygon points);
+
+/**
+ * @brief Floor projections of all collision shapes of a link placed at link_tf.
+ * @return False if the link has shapes that cannot be projected (planes, octrees), which are left out
+ */
+bool getLinkFloorShapes(const tesseract_scene_graph::Link& link, const Eigen::Isometry3d& link_tf,
+                        std::vector<FloorShape>& shapes);
+
+/**
+ * @brief Axis aligned bounds of the floor projection of a link's collision geometry at its current pose.
+ * @return False if the link has no collision geometry whose extent can be computed
+ */
+bool getLinkFloorBounds(const tesseract_environment::Environment& env, const std::string& link_name,
+                        Eigen::AlignedBox2d& bounds);
+
+/**
+ * @brief Floor footprint and height range of the base while driving, relative to its position.
+ * The base is placed the way the grid planner places it: at height 0.13 without rotation.
+ * @return False if the base link has no collision geometry
+ */
+bool getBaseFootprint(const tesseract_environment::Environment& env, const std::string& base_link_name,
+                      FloorShape& footprint);
+
+/**
+ * @brief Collect every cell whose center puts the base footprint in contact with the shape.
+ * The shape is grown by the footprint (Minkowski sum) and the result is filled row by row.
+ * Shapes entirely above or below the footprint are skipped.
+ * @param cells Receives the row major indices (y * grid_size_x + x) of the cells
+ */
+void rasteriseShape(const FloorShape& shape, const FloorShape& footprint, const MapInfo& map,
+                    std::vector<std::size_t>& cells);
+
+/** @brief Floor covered by the base footprint with the base link at the given pose, turned about z only. */
+FloorShape placeFootprint(const FloorShape& footprint, const Eigen::Isometry3d& base_tf);
+
+/**
+ * @brief Cells in which the base would touch any of the swept shapes, e.g. of a door the robot is opening,
+ * except those in which it would overlap the floor it stands on. The robot usually stands in the swept floor
+ * while it opens the door, and has to be able to leave it.
+ * @param standing The base footprint at the current pose of the base, see placeFootprint()
+ * @param cells Receives the row major indices of the cells, sorted and without duplicates
+ */
+void rasteriseSweptShapes(const std::vector<FloorShape>& shapes, const FloorShape& footprint,
+                          const FloorShape& standing, const MapInfo& map, std::vector<std::size_t>& cells);
+
+/**
+ * @brief Floor map fitted to the scene: the bounds of all obstacles in the height range of the base and
+ * the base itself, grown by the margin and the base radius so that the base can drive around everything.
+ * The step size resolves the narrowest gap between obstacles the base fits through, within the given limits,
+ * unless that takes more than max_cells cells; the map is uniform, so a finer step refines all of it.
+ * @param robot_links Links of the robot, they are not obstacles
+ * @param max_cells Cell budget of the map, 0 for none; max_step is kept even if it exceeds the budget
+ */
+MapInfo fitMapInfo(const tesseract_environment::Environment& env, const std::vector<std::string>& robot_links,
+                   double min_step = 0.025, double max_step = 0.1, double margin = 0.5, std::size_t max_cells = 40000);
+
+}  // namespace vkc
+
+#endif  // VKC_FLOOR_GEOMETRY_H
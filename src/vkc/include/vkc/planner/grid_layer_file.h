@@ -0,0 +1,93 @@
+#ifndef VKC_GRID_LAYER_FILE_H
+#define VKC_GRID_LAYER_FILE_H
+
+#include <tesseract_environment/core/environment.h>
+
+#include <vkc/planner/map_info.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+/** @brief Cell type of a layer in a grid layer file. */
+enum class GridLayerType : std::uint32_t
+{
+  OCCUPANCY = 0, /**< @brief One std::int8_t per cell, see AStar::CollisionMap */
+  COST = 1       /**< @brief One float per cell */
+};
+
+/** @brief Version of the file format, files of other versions are ignored. */
+const std::uint32_t GRID_LAYER_FILE_VERSION = 1;
+
+/**
+ * @brief Write floor grid layers that share one map layout, e.g. an occupancy grid and the cost layers
+ * derived from it, to a binary file.
+ *
+ * The file starts with a fixed size header (magic, format version, layer count, the hash of the scene
+ * geometry the layers were computed from and the map layout), followed by one table entry per layer
+ * (type and offset) and the row major cells of every layer, each starting at a multiple of 8 bytes.
+ * Numbers are stored in the byte order of the machine, files are not meant to be moved between machines.
+ * The file is replaced atomically, so readers never see a partial file.
+ * @return False if the file cannot be written or the layers do not match the map
+ */
+bool writeGridLayers(const std::string& path, const MapInfo& map, std::uint64_t geometry_hash,
+                     const std::vector<const std::vector<std::int8_t>*>& occupancy_layers,
+                     const std::vector<const std::vector<float>*>& cost_layers = {});
+
+/**
+ * @brief Read only view of a grid layer file, mapped into memory instead of read.
+ * Layers are only paged in when their cells are accessed, so opening a file costs the same for any map size.
+ */
+class MappedGridLayers
+{
+public:
+  MappedGridLayers();
+  ~MappedGridLayers();
+  MappedGridLayers(const MappedGridLayers&) = delete;
+  MappedGridLayers& operator=(const MappedGridLayers&) = delete;
+
+  /**
+   * @brief Map a file, unmapping the previous one.
+   * @return False if the file does not exist, is of another version or is truncated
+   */
+  bool open(const std::string& path);
+  void close();
+  bool isOpen() const;
+
+  const MapInfo& getMapInfo() const;
+  std::uint64_t getGeometryHash() const;
+
+  std::size_t getLayerCount() const;
+  GridLayerType getLayerType(std::size_t layer) const;
+
+  /** @brief Cells of an occupancy layer, nullptr for other layer types. */
+  const std::int8_t* getOccupancy(std::size_t layer) const;
+
+  /** @brief Cells of a cost layer, nullptr for other layer types. */
+  const float* getCost(std::size_t layer) const;
+
+private:
+  const unsigned char* data_;
+  std::size_t size_;
+  MapInfo map_;
+  std::uint64_t geometry_hash_;
+  std::vector<GridLayerType> types_;
+  std::vector<std::uint64_t> offsets_;
+};
+
+/**
+ * @brief Hash of the collision geometry of the given links, their shapes, sizes and poses.
+ * Unlike std::hash, the value only depends on the geometry, so it can identify files across runs.
+ * @param shape_links Links of which only the shapes are hashed, e.g. the robot base a grid was tested with
+ * @return 0 if a link has geometry whose content cannot be hashed (octrees), nothing should be stored for it
+ */
+std::uint64_t hashCollisionGeometry(const tesseract_environment::Environment& env,
+                                    const std::vector<std::string>& link_names,
+                                    const std::vector<std::string>& shape_links = {});
+
+}  // namespace vkc
+
+#endif  // VKC_GRID_LAYER_FILE_H
@@ -0,0 +1,76 @@
+#ifndef VKC_HEADING_GRID_H
+#define VKC_HEADING_GRID_H
+
+#include <AStar.hpp>
+
+#include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/map_info.h>
+
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Base grid with one layer per base heading, for bases that only fit through a passage at the
+ * right angle.
+ *
+ * Layer k blocks the cells where the base, turned by k full turns / heading count, touches an obstacle.
+ * The layers are rasterised like the single heading grid, with the footprint rotated for each of them.
+ * The search moves the base to the 8 neighbouring cells of a layer or turns it in place to a
+ * neighbouring layer; a turn only checks the two headings it connects, not the ones in between.
+ */
+class HeadingGrid
+{
+public:
+  struct State
+  {
+    int x;
+    int y;
+    int heading;
+  };
+  using Path = std::vector<State>;
+
+  HeadingGrid(const MapInfo& map, int heading_count = 16);
+
+  /**
+   * @brief Rasterise all layers for the current state of the environment.
+   * @param swept_shapes Floor the base has to keep clear of in addition to the scene, see rasteriseSweptShapes()
+   * @return False if the scene has shapes that cannot be rasterised or the base has no geometry
+   */
+  bool build(VKCEnvBasic& env, const std::vector<FloorShape>& swept_shapes = std::vector<FloorShape>());
+
+  const MapInfo& getMapInfo() const;
+  int getHeadingCount() const;
+
+  /** @brief Rotation of the base about z in layer k, in [0, 2 pi). */
+  double getHeadingAngle(int heading) const;
+
+  /** @brief Layer closest to the rotation of the base about z. */
+  int toHeading(double angle) const;
+
+  /** @brief Cells and layers outside the grid are blocked. */
+  bool isFree(int x, int y, int heading) const;
+
+  /** @brief Row major cells of one layer, in the convention of AStar::CollisionMap. */
+  const AStar::CollisionMap& getLayer(int heading) const;
+
+  /**
+   * @brief Shortest path from start to the goal cell, turning costs as much as moving the base one cell.
+   * Like the single heading search, the start and goal cells are never blocked.
+   * @param goal_heading Layer to arrive in, or -1 for any
+   * @param path Receives the states from start to goal
+   * @return False if no path exists
+   */
+  bool findPath(const State& start, int goal_x, int goal_y, int goal_heading, Path& path) const;
+
+private:
+  std::size_t stateIndex(int x, int y, int heading) const;
+
+  MapInfo map_;
+  int heading_count_;
+  std::vector<AStar::CollisionMap> layers_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_HEADING_GRID_H
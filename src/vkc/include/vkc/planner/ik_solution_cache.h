@@ -0,0 +1,121 @@
+#ifndef VKC_IK_SOLUTION_CACHE_H
+#define VKC_IK_SOLUTION_CACHE_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc
+{
+/** @brief Version of the cache file format, files of other versions are ignored. */
+const std::uint32_t IK_SOLUTION_CACHE_VERSION = 2;
+
+/**
+ * @brief Valid inverse kinematics solutions of past targets, used to seed the search for targets close to them,
+ * e.g. when the same handle is grasped again.
+ *
+ * Solutions are grouped by the joints of the chain they solve, since the chain grows with every attached object.
+ * Within a group, targets are kept in a KD-tree over their position and the x and y axes of their orientation.
+ * The distance of two targets is the Euclidean distance of these points: the distance of the positions combined
+ * with orientation_weight times the distance of the axes, which is about the angle between the orientations in
+ * radians for small angles.
+ *
+ * Solutions only hold in the scene they were found in, so a storage file carries a key of its scene and is
+ * only read back for the same scene.
+ */
+class IKSolutionCache
+{
+public:
+  /**
+   * @param orientation_weight Meters a radian of rotation counts as
+   * @param max_entries Solutions kept per chain, further ones are dropped
+   */
+  explicit IKSolutionCache(double orientation_weight = 0.5, std::size_t max_entries = 4096);
+
+  /**
+   * @brief Store the solution of a target, replacing that of a stored target closer than 1 mm (or mrad).
+   */
+  void add(const std::vector<std::string>& joint_names, const Eigen::Isometry3d& target,
+           const Eigen::VectorXd& solution);
+
+  /**
+   * @brief Solutions of the stored targets nearest to a target, nearest first.
+   * @param k Largest number of solutions returned
+   * @param max_distance Targets further away are left out
+   */
+  std::vector<Eigen::VectorXd> getNearest(const std::vector<std::string>& joint_names,
+                                          const Eigen::Isometry3d& target, std::size_t k, double max_distance) const;
+
+  /** @brief Number of solutions of all chains. */
+  std::size_t size() const;
+
+  /**
+   * @brief Keep the solutions of a scene in a file across runs. Does nothing if path and scene are unchanged.
+   * Otherwise solutions not saved yet are written to the previous file, the cache is cleared and the solutions
+   * in the new file are added if it was saved for the same scene. A file of another scene is replaced on save.
+   * @param path Cache file, its directory has to exist; empty to keep solutions in memory only
+   * @param scene_key Identifies the scene across runs, e.g. a hash of its static geometry; 0 if the scene cannot
+   * be identified, solutions are then kept in memory only
+   * @return False if the file exists but cannot be read
+   */
+  bool setStorageFile(const std::string& path, std::uint64_t scene_key);
+
+  std::uint64_t getSceneKey() const;
+
+  /**
+   * @brief Write all solutions to the storage file, replacing it atomically. Does nothing without one, or if no
+   * solution was added since the last save.
+   * @return False if the file cannot be written
+   */
+  bool save();
+
+private:
+  typedef Eigen::Matrix<double, 9, 1> Key;    /**< @brief Position, weighted x and y axes */
+  typedef Eigen::Matrix<double, 7, 1> Target; /**< @brief Position and quaternion w, x, y, z, as stored */
+
+  struct Node
+  {
+    Key key;
+    Target target;
+    Eigen::VectorXd solution;
+    int left;
+    int right;
+  };
+
+  /** @brief Unbalanced KD-tree grown by insertion, the root is nodes[0] and level i splits on coordinate i % 9. */
+  struct Chain
+  {
+    std::vector<std::string> joint_names;
+    std::vector<Node> nodes;
+  };
+
+  Key makeKey(const Target& target) const;
+
+  void insert(Chain& chain, const Target& target, const Eigen::VectorXd& solution);
+
+  /** @brief Indices of the k nodes nearest to key within max_distance, nearest first. */
+  std::vector<int> findNearest(const Chain& chain, const Key& key, std::size_t k, double max_distance) const;
+
+  /** @brief Add the solutions of a file, none if it was saved for another scene key. False if it cannot be read. */
+  bool load(const std::string& path);
+
+  static std::string getChainKey(const std::vector<std::string>& joint_names);
+
+  double orientation_weight_;
+  std::size_t max_entries_;
+  std::string storage_file_;
+  std::uint64_t scene_key_;
+  bool modified_; /**< @brief Solutions were added since the last save */
+  std::unordered_map<std::string, Chain> chains_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_IK_SOLUTION_CACHE_H
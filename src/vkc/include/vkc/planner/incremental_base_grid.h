@@ -0,0 +1,83 @@
+#ifndef VKC_INCREMENTAL_BASE_GRID_H
+#define VKC_INCREMENTAL_BASE_GRID_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <AStar.hpp>
+
+#include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/floor_geometry.h>
+#include <vkc/planner/map_info.h>
+#include <vkc/planner/static_base_layer.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Rasterised base grid that follows scene changes link by link.
+ *
+ * The first update() rasterises every obstacle link and remembers the cells each one covers, together
+ * with the pose it was rasterised at. Cells count how many links cover them. Later updates compare the
+ * link poses with the remembered ones and only remove and re-rasterise the links that moved, were
+ * attached to the robot or were released by it, so the work per action is proportional to the objects
+ * that changed rather than to the map.
+ * If the environment has a static base layer for the map, only the dynamic links are tracked and the
+ * static cells are added when the grid is exported.
+ */
+class IncrementalBaseGrid
+{
+public:
+  explicit IncrementalBaseGrid(const MapInfo& map);
+
+  /**
+   * @brief Bring the grid up to date with the current state of the environment.
+   * @return False if the scene has shapes that cannot be rasterised or the base has no geometry,
+   * the grid must then be built from contact tests instead
+   */
+  bool update(VKCEnvBasic& env);
+
+  /** @brief Replace the collision map of the A* generator with the grid. */
+  void exportTo(AStar::Generator& astar_generator) const;
+
+  const MapInfo& getMapInfo() const;
+
+  /** @brief Links rasterised again by the last update(), all of them on the first one. */
+  std::size_t getUpdatedLinkCount() const;
+
+private:
+  struct LinkCells
+  {
+    Eigen::Isometry3d tf; /**< @brief Pose the cells were rasterised at */
+    std::vector<std::size_t> cells;
+    bool supported;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  void addLink(const tesseract_scene_graph::Link& link, const Eigen::Isometry3d& tf, LinkCells& link_cells);
+  void removeLink(const LinkCells& link_cells);
+
+  MapInfo map_;
+  bool has_footprint_;
+  FloorShape footprint_;
+  std::unordered_map<std::string, LinkCells, std::hash<std::string>, std::equal_to<std::string>,
+                     Eigen::aligned_allocator<std::pair<const std::string, LinkCells>>>
+      links_;
+  std::vector<std::uint16_t> cover_; /**< @brief Number of links blocking each cell */
+  bool has_static_layer_;            /**< @brief Set by the first update, the links tracked depend on it */
+  StaticBaseLayer::Ptr static_layer_;
+  StaticBaseLayer::CellsPtr static_cells_;
+  std::size_t updated_links_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_INCREMENTAL_BASE_GRID_H
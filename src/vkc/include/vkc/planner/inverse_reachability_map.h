@@ -0,0 +1,99 @@
+#ifndef VKC_INVERSE_REACHABILITY_MAP_H
+#define VKC_INVERSE_REACHABILITY_MAP_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract_kinematics/core/forward_kinematics.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc
+{
+/** @brief Version of the map file format, files of other versions are ignored. */
+const std::uint32_t INVERSE_REACHABILITY_MAP_VERSION = 1;
+
+/**
+ * @brief Where a mobile base can stand to reach an end effector pose with its arm, from a map of the arm's
+ * workspace computed offline.
+ *
+ * Random arm configurations are voxelised by the height, roll and pitch of the end effector relative to the
+ * base, which do not change when the base moves on the floor. Every voxel keeps the planar offsets and headings
+ * of the base relative to the end effector that reach it, scored by the best manipulability found for them
+ * (sqrt(det(J J^T)), normalised to the best configuration of the whole map). Base placements for a target are
+ * then read from the voxel of the target, ranked by score.
+ */
+class InverseReachabilityMap
+{
+public:
+  struct BasePlacement
+  {
+    double x;
+    double y;
+    double theta; /**< @brief Heading of the base about z */
+    double score; /**< @brief Normalised manipulability, in (0, 1] */
+  };
+
+  InverseReachabilityMap();
+
+  /**
+   * @brief Sample the arm and invert its workspace, replacing the current map.
+   * @param arm_kin Arm from the base link, which moves on the floor without roll or pitch, to the end effector
+   * @param n_samples Number of random configurations within the joint limits
+   * @param position_step Voxel size for the height of the end effector and the offsets of the base
+   * @param angle_step Voxel size for roll and pitch of the end effector and the heading of the base
+   * @return False if the arm has no configuration with a non singular jacobian
+   */
+  bool build(const tesseract_kinematics::ForwardKinematics& arm_kin, std::size_t n_samples,
+             double position_step = 0.05, double angle_step = M_PI / 12, unsigned random_seed = 0);
+
+  bool empty() const;
+
+  /** @brief Links the map was built for, the poses it is queried with are poses of the tip link. */
+  const std::string& getBaseLinkName() const;
+  const std::string& getTipLinkName() const;
+
+  /**
+   * @brief Base placements from which the arm reaches a target, best first.
+   * @param target Pose of the tip link in the world
+   * @param base_z Height of the base link
+   * @param max_count Largest number of placements returned
+   */
+  std::vector<BasePlacement> getBasePlacements(const Eigen::Isometry3d& target, double base_z,
+                                               std::size_t max_count) const;
+
+  /** @return False if the file cannot be written */
+  bool save(const std::string& path) const;
+
+  /** @return False if the file does not exist or is of another version, the map is then left empty */
+  bool load(const std::string& path);
+
+private:
+  struct Placement
+  {
+    std::int16_t x;
+    std::int16_t y;
+    std::int16_t theta;
+    float score;
+  };
+
+  /** @brief Voxel of the end effector height, roll and pitch. */
+  std::int64_t getVoxel(double z, double roll, double pitch) const;
+
+  std::string base_link_name_;
+  std::string tip_link_name_;
+  double position_step_;
+  double angle_step_;
+  std::unordered_map<std::int64_t, std::vector<Placement>> voxels_; /**< @brief Placements sorted by score */
+};
+
+}  // namespace vkc
+
+#endif  // VKC_INVERSE_REACHABILITY_MAP_H
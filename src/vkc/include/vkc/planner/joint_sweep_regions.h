@@ -0,0 +1,69 @@
+#ifndef VKC_JOINT_SWEEP_REGIONS_H
+#define VKC_JOINT_SWEEP_REGIONS_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract_environment/core/environment.h>
+
+#include <vkc/planner/floor_geometry.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Floor area swept by the articulated parts of the scene, e.g. a cabinet door swinging open.
+ *
+ * Each joint is sampled over its range once. The floor shapes of the links it moves at two neighbouring
+ * samples are joined by their convex hull, which covers the motion in between up to the sag of the arc.
+ * A base path planned around the region of an action stays clear of the part while the robot moves it.
+ */
+class JointSweepRegions
+{
+public:
+  using Ptr = std::shared_ptr<JointSweepRegions>;
+  using ConstPtr = std::shared_ptr<const JointSweepRegions>;
+
+  /**
+   * @brief Sample the given joints in the current state of the environment.
+   * Joints that are neither revolute, continuous nor prismatic, or whose links cannot be projected on
+   * the floor (planes, octrees), are left out.
+   * @param resolution Largest joint step between samples, in radians or meters
+   */
+  void build(const tesseract_environment::Environment& env, const std::vector<std::string>& joint_names,
+             double resolution = 0.05);
+
+  bool hasJoint(const std::string& joint_name) const;
+
+  /**
+   * @brief Add the floor shapes swept while the joint moves between two positions, clamped to its range.
+   * @return False if the joint is unknown or the link it is mounted on moved since build(), nothing is added
+   */
+  bool getSweptShapes(const tesseract_environment::Environment& env, const std::string& joint_name, double from,
+                      double to, std::vector<FloorShape>& shapes) const;
+
+private:
+  struct JointSweep
+  {
+    std::string parent_link;
+    Eigen::Isometry3d parent_tf; /**< @brief Pose of the parent link the shapes were computed at */
+    std::vector<double> positions;
+    std::vector<std::vector<FloorShape>> segments; /**< @brief Shapes swept between positions i and i + 1 */
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  std::unordered_map<std::string, JointSweep, std::hash<std::string>, std::equal_to<std::string>,
+                     Eigen::aligned_allocator<std::pair<const std::string, JointSweep>>>
+      sweeps_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_JOINT_SWEEP_REGIONS_H
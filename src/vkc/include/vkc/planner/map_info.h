@@ -0,0 +1,90 @@
+#ifndef VKC_MAP_INFO_H
+#define VKC_MAP_INFO_H
+
+#include <algorithm>
+#include <cmath>
+
+namespace vkc
+{
+/**
+ * @brief Size and resolution of the floor grid used to seed base trajectories.
+ * Cell (0, 0) is centered at (origin_x, origin_y), the map extends by map_x and map_y from there.
+ */
+struct MapInfo
+{
+  double map_x;
+  double map_y;
+  double step_size;
+  int grid_size_x;
+  int grid_size_y;
+  double origin_x;
+  double origin_y;
+
+  /** @brief Map of x by y meters centered at the world origin. */
+  MapInfo(double x, double y, double step)
+    : map_x(x), map_y(y), step_size(step), origin_x(-x / 2.0), origin_y(-y / 2.0)
+  {
+    grid_size_x = int(map_x / step_size) + 1;
+    grid_size_y = int(map_y / step_size) + 1;
+  }
+
+  /**
+   * @brief Smallest map covering the given bounds.
+   * The origin is snapped to a multiple of the step size, so that maps of overlapping bounds share their cells.
+   */
+  static MapInfo fromBounds(double min_x, double min_y, double max_x, double max_y, double step)
+  {
+    MapInfo map(0, 0, step);
+    map.origin_x = std::floor(min_x / step + 1e-9) * step;
+    map.origin_y = std::floor(min_y / step + 1e-9) * step;
+    map.grid_size_x = std::max(1, int(std::ceil((max_x - map.origin_x) / step - 1e-9)) + 1);
+    map.grid_size_y = std::max(1, int(std::ceil((max_y - map.origin_y) / step - 1e-9)) + 1);
+    map.map_x = (map.grid_size_x - 1) * step;
+    map.map_y = (map.grid_size_y - 1) * step;
+    return map;
+  }
+
+  /** @brief True if the point lies within the outermost cell centers. */
+  bool contains(double x, double y) const
+  {
+    return x >= origin_x && x <= origin_x + map_x && y >= origin_y && y <= origin_y + map_y;
+  }
+
+  /** @brief Grow the map so that it contains the point with the given margin, keeping the existing cells. */
+  void extend(double x, double y, double margin)
+  {
+    *this = fromBounds(std::min(origin_x, x - margin), std::min(origin_y, y - margin),
+                       std::max(origin_x + map_x, x + margin), std::max(origin_y + map_y, y + margin), step_size);
+  }
+
+  /** @brief Same cells, i.e. grids of both maps can be exchanged. */
+  bool operator==(const MapInfo& other) const
+  {
+    return grid_size_x == other.grid_size_x && grid_size_y == other.grid_size_y && step_size == other.step_size &&
+           std::abs(origin_x - other.origin_x) < 1e-9 && std::abs(origin_y - other.origin_y) < 1e-9;
+  }
+
+  int toGridX(double x) const
+  {
+    return int(round((x - origin_x) / step_size));
+  }
+
+  int toGridY(double y) const
+  {
+    return int(round((y - origin_y) / step_size));
+  }
+
+  double toWorldX(int x) const
+  {
+    return origin_x + x * step_size;
+  }
+
+  double toWorldY(int y) const
+  {
+    return origin_y + y * step_size;
+  }
+};
+
+}  // namespace vkc
+
+#endif  // VKC_MAP_INFO_H
@@ -0,0 +1,31 @@
+#ifndef VKC_OCCUPANCY_BUILDER_H
+#define VKC_OCCUPANCY_BUILDER_H
+
+#include <AStar.hpp>
+
+#include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/floor_geometry.h>
+#include <vkc/planner/map_info.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+/** @brief Block the cells collected by rasteriseShape() in the A* generator. */
+void rasteriseShape(const FloorShape& shape, const FloorShape& footprint, const MapInfo& map,
+                    AStar::Generator& astar_generator);
+
+/**
+ * @brief Build the base grid by rasterising the collision shapes of the scene instead of contact testing every cell.
+ * Marks the same cells as moving base_link over the grid with contact tests, up to the polygon
+ * approximation of round shapes and the convex hull of meshes, which can only block more cells.
+ * @return False if the scene has shapes that cannot be rasterised (planes, octrees) or the base has no
+ * geometry; the grid is then incomplete and should be built from contact tests instead.
+ */
+bool rasteriseBaseGrid(VKCEnvBasic& env, const MapInfo& map, AStar::Generator& astar_generator);
+
+}  // namespace vkc
+
+#endif  // VKC_OCCUPANCY_BUILDER_H
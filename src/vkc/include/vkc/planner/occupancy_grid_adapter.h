@@ -0,0 +1,49 @@
+#ifndef VKC_OCCUPANCY_GRID_ADAPTER_H
+#define VKC_OCCUPANCY_GRID_ADAPTER_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <nav_msgs/OccupancyGrid.h>
+#include <ros/console.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <AStar.hpp>
+
+#include <vkc/planner/map_info.h>
+
+namespace vkc
+{
+/**
+ * @brief Fill the map meta data (size, resolution, origin) of an occupancy grid message from MapInfo.
+ * Cell (x, y) of the base grid is centered at MapInfo::toWorldX(x), MapInfo::toWorldY(y).
+ */
+void toMapMetaData(const MapInfo& map, nav_msgs::MapMetaData& info);
+
+/**
+ * @brief Map of the cells described by the meta data of an occupancy grid message, the inverse of toMapMetaData().
+ * The rotation of the origin is ignored, see isCompatible().
+ */
+MapInfo fromMapMetaData(const nav_msgs::MapMetaData& info);
+
+/**
+ * @brief Check that an occupancy grid message has the layout described by MapInfo: size, resolution,
+ * and the origin toMapMetaData() writes, without rotation.
+ */
+bool isCompatible(const MapInfo& map, const nav_msgs::OccupancyGrid& grid);
+
+/**
+ * @brief Hand the collision map of the A* generator over to an occupancy grid message.
+ * The cell buffer is swapped, not copied, so the generator is left holding the previous
+ * content of grid.data until importOccupancyGrid() gives the buffer back.
+ */
+void exportOccupancyGrid(AStar::Generator& generator, const MapInfo& map, nav_msgs::OccupancyGrid& grid);
+
+/**
+ * @brief Hand the cells of an occupancy grid message over to the A* generator without copying.
+ * @return False if the message does not match MapInfo, in which case nothing is exchanged.
+ */
+bool importOccupancyGrid(nav_msgs::OccupancyGrid& grid, const MapInfo& map, AStar::Generator& generator);
+
+}  // namespace vkc
+
+#endif  // VKC_OCCUPANCY_GRID_ADAPTER_H
@@ -0,0 +1,125 @@
+#ifndef VKC_PLANAR_BASE_UR_INV_KIN_H
+#define VKC_PLANAR_BASE_UR_INV_KIN_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract_kinematics/core/forward_kinematics.h>
+#include <tesseract_kinematics/core/inverse_kinematics.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Closed form inverse kinematics of a UR arm on a planar mobile base, for a chain of base joints, the
+ * six arm joints and any joints of attached objects after the arm.
+ *
+ * The arm is solved with products of exponentials: the axis of every arm joint is measured once from the
+ * forward kinematics of the chain, so no DH parameters or link frame conventions of the description are
+ * assumed, only the structure of the UR family (the axes of joints 2 to 4 parallel, those of joints 5 and 6
+ * intersecting). A base pose yields up to 8 arm solutions (shoulder, elbow and wrist branches).
+ *
+ * The base pose (x, y, theta) of the seed is tried first. If the arm cannot reach the target from it, base
+ * poses are sampled around the target within reach of the arm until one can. Joints of attached objects keep
+ * their seed values.
+ */
+class PlanarBaseURInvKin : public tesseract_kinematics::InverseKinematics
+{
+public:
+  using Ptr = std::shared_ptr<PlanarBaseURInvKin>;
+  using ConstPtr = std::shared_ptr<const PlanarBaseURInvKin>;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /** @brief Create a solver, allocated with the alignment of its fixed size members. */
+  static Ptr create();
+
+  PlanarBaseURInvKin() = default;
+  ~PlanarBaseURInvKin() override = default;
+  PlanarBaseURInvKin(const PlanarBaseURInvKin&) = delete;
+  PlanarBaseURInvKin& operator=(const PlanarBaseURInvKin&) = delete;
+  PlanarBaseURInvKin(PlanarBaseURInvKin&&) = delete;
+  PlanarBaseURInvKin& operator=(PlanarBaseURInvKin&&) = delete;
+
+  /**
+   * @brief Solutions of all arm branches for one base pose, closest to the seed first, one after the other.
+   */
+  bool calcInvKin(Eigen::VectorXd& solutions, const Eigen::Isometry3d& pose,
+                  const Eigen::Ref<const Eigen::VectorXd>& seed) const override;
+
+  /** @brief Only supported for the tip link of the chain. */
+  bool calcInvKin(Eigen::VectorXd& solutions, const Eigen::Isometry3d& pose,
+                  const Eigen::Ref<const Eigen::VectorXd>& seed, const std::string& link_name) const override;
+
+  bool checkJoints(const Eigen::Ref<const Eigen::VectorXd>& vec) const override;
+
+  const std::vector<std::string>& getJointNames() const override;
+  const std::vector<std::string>& getLinkNames() const override;
+  const std::vector<std::string>& getActiveLinkNames() const override;
+  const Eigen::MatrixX2d& getLimits() const override;
+  tesseract_scene_graph::SceneGraph::ConstPtr getSceneGraph() const override;
+  unsigned int numJoints() const override;
+  const std::string& getBaseLinkName() const override;
+  const std::string& getTipLinkName() const override;
+  const std::string& getName() const override;
+  const std::string& getSolverName() const override;
+  tesseract_kinematics::InverseKinematics::Ptr clone() const override;
+
+  /**
+   * @brief Set up the solver for a chain.
+   * @param fwd_kin Forward kinematics of the whole chain
+   * @param name Name of the group the solver is registered for
+   * @param base_joints Joints of the base moving it along x and y and turning it about z, in this order
+   * @param arm_joints The six arm joints from the shoulder to the wrist
+   * @param arm_base_link Link the first arm joint is mounted on
+   * @param arm_tip_link Link moved by the last arm joint
+   * @param base_samples Base poses sampled around the target when the arm cannot reach it from the seed
+   * @return False if the chain lacks a joint or the arm does not have the structure of a UR arm
+   */
+  bool init(tesseract_kinematics::ForwardKinematics::ConstPtr fwd_kin, const std::string& name,
+            const std::vector<std::string>& base_joints, const std::vector<std::string>& arm_joints,
+            const std::string& arm_base_link, const std::string& arm_tip_link, int base_samples = 32);
+
+private:
+  /**
+   * @brief Add the arm solutions within the joint limits for the base pose of joints to solutions.
+   * @param arm_target Pose of the arm tip link in the world
+   * @param joints Values of the chain, only the base and object joints are used
+   */
+  void solveArm(const Eigen::Isometry3d& arm_target, const Eigen::VectorXd& joints,
+                std::vector<Eigen::VectorXd>& solutions) const;
+
+  /** @brief Pose of the arm tip relative to the arm base link, from the products of exponentials. */
+  Eigen::Isometry3d calcArmFwdKin(const double* arm_values) const;
+
+  /** @brief Value of an arm joint shifted by whole turns into its limits, closest to the seed. */
+  bool wrapToLimits(int joint, double seed_value, double& value) const;
+
+  bool initialized_ = false;
+  tesseract_kinematics::ForwardKinematics::Ptr fwd_kin_;
+  std::string name_;
+  std::string solver_name_ = "PlanarBaseURInvKin";
+  std::vector<std::string> joint_names_;
+  Eigen::MatrixX2d limits_;
+  long base_index_[3];
+  long arm_index_[6];
+  std::string arm_base_link_;
+  std::string arm_tip_link_;
+  Eigen::Vector3d axes_[6];        /**< @brief Unit axes of the arm joints in the arm base link, at zero */
+  Eigen::Vector3d axis_points_[6]; /**< @brief A point on each axis */
+  Eigen::Vector3d wrist_point_;    /**< @brief Intersection of the axes of joints 5 and 6 */
+  Eigen::Isometry3d home_;         /**< @brief Arm tip relative to the arm base link with the arm at zero */
+  double reach_ = 0;               /**< @brief Bound on the horizontal distance of the arm tip from the base */
+  int base_samples_ = 32;
+  mutable std::minstd_rand rng_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_PLANAR_BASE_UR_INV_KIN_H
@@ -5,6 +5,7 @@
 TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
 #include <ros/ros.h>
 #include <trajopt/problem_description.hpp>
+#include <nav_msgs/OccupancyGrid.h>
 TESSERACT_COMMON_IGNORE_WARNINGS_POP
 
 #include <tesseract_environment/core/utils.h>
@@ -17,6 +18,11 @@ TESSERACT_COMMON_IGNORE_WARNINGS_POP
 #include <trajopt_utils/logging.hpp>
 
 #include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/base_grid_cache.h>
+#include <vkc/planner/ik_solution_cache.h>
+#include <vkc/planner/inverse_reachability_map.h>
+#include <vkc/planner/traj_init_options.h>
+#include <vkc/planner/traj_init_stats.h>
 
 #include <iostream>
 #include <string>
@@ -29,6 +35,9 @@ class ProbGenerator
 public:
   ProbGenerator();
 
+  // Saves the inverse kinematics solutions found since the last save
+  ~ProbGenerator();
+
 public:
   trajopt::TrajOptProb::Ptr genProb(VKCEnvBasic &env, ActionBase::Ptr action, int n_steps);
   trajopt::TrajOptProb::Ptr genPickProb(VKCEnvBasic &env, PickAction::Ptr act, int n_steps);
@@ -36,6 +45,25 @@ public:
   trajopt::TrajOptProb::Ptr genGotoProb(VKCEnvBasic &env, GotoAction::Ptr act, int n_steps);
   trajopt::TrajOptProb::Ptr genUseProb(VKCEnvBasic &env, UseAction::Ptr act, int n_steps);
 
+  // Floor grid used to seed the base trajectory of the last generated problem, e.g. for publishing
+  const nav_msgs::OccupancyGrid &getBaseGrid() const;
+
+  // Floor grid from outside, e.g. a map server, searched for base paths instead of one built from the scene.
+  // Its cells replace the fitted floor map; an empty grid (default) builds the grid from the scene again.
+  void setInputGrid(const nav_msgs::OccupancyGrid &grid);
+
+  // Settings of trajectory initialization; the reachability map is read when they are set, the inverse
+  // kinematics cache with the first problem of a scene, since only solutions of the same scene are read
+  void setTrajInitOptions(const TrajInitOptions &options);
+
+  const TrajInitOptions &getTrajInitOptions() const;
+
+  // Stage timings of trajectory initialization are added to stats, nullptr (default) to skip timing
+  void setTrajInitStats(TrajInitStats *stats);
+
+  // Write the inverse kinematics solutions found since the last save to the cache file of the options
+  bool saveIKCache();
+
 protected:
   int initProbInfo(trajopt::ProblemConstructionInfo &pci, tesseract::Tesseract::Ptr tesseract, int n_steps,
                    std::string manip);
@@ -56,8 +84,24 @@ protected:
   void addTargetCost(trajopt::ProblemConstructionInfo &pci, LinkDesiredPose &link_pose, Eigen::Vector3d pos_coeff,
                      Eigen::Vector3d rot_coeff);
 
+  // Floor map fitted to the current scene, with cells no larger than max_step, or the one of the input grid
+  MapInfo fitBaseMap(VKCEnvBasic &env, double max_step);
+
+  // Floor swept by the articulated parts the joint objectives move, from their current positions
+  std::vector<FloorShape> getSweptShapes(VKCEnvBasic &env, const std::vector<JointDesiredPose> &joint_objectives);
+
+  // Caches and outputs of the generator for initTrajectory, with the floor swept by the action if any
+  TrajInitContext getTrajInitContext(const std::vector<FloorShape> *swept_shapes = nullptr);
+
 private:
   std::unordered_map<std::string, int> planned_joints;
+  nav_msgs::OccupancyGrid base_grid_;
+  nav_msgs::OccupancyGrid input_grid_;
+  BaseGridCache base_grid_cache_; /**< @brief Base grids reused across retries and actions on an unchanged scene */
+  IKSolutionCache ik_solution_cache_; /**< @brief Solutions of past inverse kinematics targets, tried first as seeds */
+  InverseReachabilityMap reachability_map_; /**< @brief Base placements reaching a target, empty if none is loaded */
+  TrajInitOptions traj_init_options_;
+  TrajInitStats *traj_init_stats_;
 };
 
 }  // namespace vkc
@@ -0,0 +1,100 @@
+#ifndef VKC_STATIC_BASE_LAYER_H
+#define VKC_STATIC_BASE_LAYER_H
+
+#include <tesseract_environment/core/environment.h>
+
+#include <vkc/planner/floor_geometry.h>
+#include <vkc/planner/map_info.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Part of the base grid that no action can change: walls, tables and the bodies of fixed base
+ * objects such as cabinets.
+ *
+ * The scene is split once into the dynamic links, i.e. objects that can be picked up and the articulated
+ * parts of fixed base objects (doors, drawers), and the static links, which are all other obstacles.
+ * Static links are rasterised once per map layout, so per action grids only have to rasterise the
+ * dynamic links and combine them with the static layer.
+ * Layers can also be kept in a storage directory, keyed by a hash of the static collision geometry and the
+ * base, where they outlive the process and are mapped back into memory instead of rasterised again.
+ */
+class StaticBaseLayer
+{
+public:
+  using Ptr = std::shared_ptr<StaticBaseLayer>;
+  using ConstPtr = std::shared_ptr<const StaticBaseLayer>;
+  /**
+   * @brief Row major cells of a layer, 100 for blocked cells as in AStar::CollisionMap.
+   * The pointer keeps alive whatever holds the cells, rasterised cells or a mapped layer file.
+   */
+  using CellsPtr = std::shared_ptr<const std::int8_t>;
+
+  /**
+   * @brief Split the obstacles of the scene in its initial state.
+   * @param robot_links Links of the robot, they are not obstacles
+   * @param dynamic_links Obstacle links that may move, all other obstacles are static
+   * @param capacity Number of map layouts kept, the least recently used one is dropped first
+   */
+  StaticBaseLayer(const tesseract_environment::Environment& env, const std::vector<std::string>& robot_links,
+                  const std::vector<std::string>& dynamic_links, std::size_t capacity = 4);
+
+  /**
+   * @brief Static cells of a map layout, loaded from the storage directory or rasterised on first use.
+   * Rasterised layers are added to the storage directory.
+   * @return nullptr if the static links cannot be rasterised (planes, octrees) or the base has no geometry
+   */
+  CellsPtr getLayer(const tesseract_environment::Environment& env, const MapInfo& map);
+
+  /**
+   * @brief Directory for layers kept across runs, created when needed. Empty (default) keeps layers in
+   * memory only. Applies to the layouts first used afterwards.
+   */
+  void setStorageDirectory(const std::string& directory);
+
+  /** @brief True for obstacle links that are covered by the static layer. */
+  bool isStatic(const std::string& link_name) const;
+
+  const std::vector<std::string>& getStaticLinks() const;
+
+  /** @brief Obstacle links that may move, as given on construction. */
+  const std::vector<std::string>& getDynamicLinks() const;
+
+  /** @brief Hash of the collision geometry of the static links and the base, 0 if it cannot be hashed. */
+  std::uint64_t getGeometryHash() const;
+
+private:
+  struct Layer
+  {
+    MapInfo map;
+    CellsPtr cells;
+  };
+
+  /** @brief Layer file of a map layout, empty if nothing can be stored. */
+  std::string getStoragePath(const MapInfo& map) const;
+
+  CellsPtr load(const MapInfo& map) const;
+  void save(const MapInfo& map, const std::vector<std::int8_t>& cells) const;
+
+  std::vector<std::string> static_links_;
+  std::vector<std::string> dynamic_links_;
+  std::unordered_set<std::string> static_link_set_;
+  std::size_t capacity_;
+  std::uint64_t geometry_hash_; /**< @brief Of the static links and the base, 0 if it cannot be hashed */
+  std::string storage_directory_;
+  std::list<Layer> layers_; /**< @brief Most recently used first */
+  std::mutex mutex_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_STATIC_BASE_LAYER_H
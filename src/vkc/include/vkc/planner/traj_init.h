@@ -4,7 +4,9 @@
 #include <tesseract_collision/core/common.h>
 #include <tesseract_common/macros.h>
 #include <tesseract_environment/core/environment.h>
+#include <tesseract_environment/core/state_solver.h>
 #include <tesseract_environment/core/utils.h>
+#include <tesseract_geometry/geometries.h>
 TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
 #include <trajopt/problem_description.hpp>
 TESSERACT_COMMON_IGNORE_WARNINGS_POP
@@ -14,27 +16,30 @@ TESSERACT_COMMON_IGNORE_WARNINGS_POP
 
 #include <stdlib.h>
 #include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
 #include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/base_grid_cache.h>
+#include <vkc/planner/floor_distance_field.h>
+#include <vkc/planner/heading_grid.h>
+#include <vkc/planner/ik_solution_cache.h>
+#include <vkc/planner/inverse_reachability_map.h>
+#include <vkc/planner/map_info.h>
+#include <vkc/planner/occupancy_builder.h>
+#include <vkc/planner/occupancy_grid_adapter.h>
+#include <vkc/planner/traj_init_options.h>
+#include <vkc/planner/traj_init_stats.h>
+#include <vkc/planner/visibility_graph.h>
 #include <cmath>
 const std::string DEFAULT_VKC_GROUP_ID = "vkc";
 
 namespace vkc
 {
-struct MapInfo
-{
-  int map_x;
-  int map_y;
-  double step_size;
-  int grid_size_x;
-  int grid_size_y;
-
-  MapInfo(int x, int y, double step) : map_x(x), map_y(y), step_size(step)
-  {
-    grid_size_x = int(map_x / step_size) + 1;
-    grid_size_y = int(map_y / step_size) + 1;
-  }
-};
-
 bool isEmptyCell(tesseract_collision::DiscreteContactManager::Ptr discrete_contact_manager, std::string link_name,
                  Eigen::Isometry3d& tf, tesseract_collision::ContactResultMap& contact_results)
 {
@@ -51,26 +56,173 @@ bool isEmptyCell(tesseract_collision::DiscreteContactManager::Ptr discrete_conta
   return true;
 }
 
-void initBaseTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, MapInfo& map)
+/**
+ * @brief Box probes for contact testing square blocks of base grid cells at once.
+ * For a block, the free probe covers the base footprint placed at every cell center of the block, and
+ * the core probe is covered by all of those footprints. No contact with the free probe clears the whole
+ * block, contact with the core probe blocks all of it. Core probes only exist for a box shaped base
+ * and for blocks smaller than the base.
+ */
+struct GridBlockProbes
 {
-  int map_x = map.map_x;
-  int map_y = map.map_y;
-  double step_size = map.step_size;
-  std::string base_link_name = "base_link";
+  int max_level;                        // top level blocks have 2^max_level cells per side
+  std::vector<std::string> free_probes; // per level, level 0 is a single cell and tested with base_link
+  std::vector<std::string> core_probes; // per level, empty if there is no core at that level
+  Eigen::Vector3d offset;               // center of the footprint box relative to the base position
+};
 
-  Eigen::Isometry3d base_start = env.getVKCEnv()->getTesseract()->getEnvironment()->getLinkTransform(base_link_name);
-  Eigen::Isometry3d base_end = base_pose.back().tf;
+/**
+ * @brief Add disabled block probes up to blocks of 2^max_level cells to the contact manager.
+ */
+GridBlockProbes addGridBlockProbes(tesseract_collision::DiscreteContactManager::Ptr contact_manager,
+                                   const FloorShape& footprint, const MapInfo& map, int max_level)
+{
+  Eigen::AlignedBox2d bounds;
+  for (auto& point : footprint.hull)
+    bounds.extend(point);
+  Eigen::Vector2d size = bounds.sizes();
+  double height = footprint.z_max - footprint.z_min;
+  bool box_shaped = footprint.hull.size() == 4 && std::abs(bounds.volume() - [&]() {
+                      double area = 0;
+                      for (std::size_t i = 0; i < 4; ++i)
+                        area += footprint.hull[i].x() * footprint.hull[(i + 1) % 4].y() -
+                                footprint.hull[(i + 1) % 4].x() * footprint.hull[i].y();
+                      return area / 2.0;
+                    }()) < 1e-9;
 
-  int base_x = int(round((base_start.translation()[0] + map_x / 2.0) / step_size));
-  int base_y = int(round((base_start.translation()[1] + map_y / 2.0) / step_size));
+  GridBlockProbes probes;
+  probes.max_level = max_level;
+  probes.offset = Eigen::Vector3d(bounds.center().x(), bounds.center().y(), (footprint.z_min + footprint.z_max) / 2.0);
+  probes.free_probes.assign(static_cast<std::size_t>(max_level) + 1, "");
+  probes.core_probes.assign(static_cast<std::size_t>(max_level) + 1, "");
 
-  int end_x = int(round((base_end.translation()[0] + map_x / 2.0) / step_size));
-  int end_y = int(round((base_end.translation()[1] + map_y / 2.0) / step_size));
+  tesseract_common::VectorIsometry3d shape_poses(1, Eigen::Isometry3d::Identity());
+  for (int level = 1; level <= max_level; ++level)
+  {
+    // distance between the outermost cell centers of the block
+    double span = ((1 << level) - 1) * map.step_size;
+
+    std::string free_name = "base_grid_free_probe_" + std::to_string(level);
+    tesseract_collision::CollisionShapesConst free_shape(
+        1, std::make_shared<tesseract_geometry::Box>(size.x() + span, size.y() + span, height));
+    contact_manager->addCollisionObject(free_name, 0, free_shape, shape_poses, false);
+    probes.free_probes[static_cast<std::size_t>(level)] = free_name;
+
+    if (box_shaped && size.x() > span && size.y() > span)
+    {
+      std::string core_name = "base_grid_core_probe_" + std::to_string(level);
+      tesseract_collision::CollisionShapesConst core_shape(
+          1, std::make_shared<tesseract_geometry::Box>(size.x() - span, size.y() - span, height));
+      contact_manager->addCollisionObject(core_name, 0, core_shape, shape_poses, false);
+      probes.core_probes[static_cast<std::size_t>(level)] = core_name;
+    }
+  }
+
+  std::vector<std::string> active = probes.free_probes;
+  active.insert(active.end(), probes.core_probes.begin(), probes.core_probes.end());
+  active.erase(std::remove(active.begin(), active.end(), ""), active.end());
+  active.push_back("base_link");
+  contact_manager->setActiveCollisionObjects(active);
+  return probes;
+}
+
+/**
+ * @brief True if the probe, placed at center, touches anything base_link is not allowed to touch.
+ */
+bool isProbeInContact(tesseract_collision::DiscreteContactManager::Ptr contact_manager,
+                      const tesseract_scene_graph::AllowedCollisionMatrix& acm, const std::string& probe,
+                      const Eigen::Vector3d& center)
+{
+  Eigen::Isometry3d probe_tf;
+  probe_tf.setIdentity();
+  probe_tf.translation() = center;
 
-  Eigen::Isometry3d base_tf;
   tesseract_collision::ContactResultMap contact_results;
+  contact_manager->enableCollisionObject(probe);
+  contact_manager->setCollisionObjectsTransform(probe, probe_tf);
+  contact_manager->contactTest(contact_results, tesseract_collision::ContactTestType::ALL);
+  contact_manager->disableCollisionObject(probe);
+
+  for (auto& collision : contact_results)
+  {
+    const std::string& other = collision.first.first == probe ? collision.first.second : collision.first.first;
+    if (!acm.isCollisionAllowed("base_link", other))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Mark the blocked cells of a square block, testing it as a whole first and subdividing it only
+ * if the block probes are inconclusive, i.e. near obstacle boundaries.
+ */
+void checkGridBlock(tesseract_collision::DiscreteContactManager::Ptr contact_manager, const GridBlockProbes& probes,
+                    const tesseract_scene_graph::AllowedCollisionMatrix& acm, const MapInfo& map, int x0, int y0,
+                    int level, AStar::CollisionMap& cells)
+{
+  if (x0 >= map.grid_size_x || y0 >= map.grid_size_y)
+    return;
+
+  auto block = [&](int x, int y) {
+    cells[static_cast<std::size_t>(y) * static_cast<std::size_t>(map.grid_size_x) + static_cast<std::size_t>(x)] = 100;
+  };
+
+  if (level == 0)
+  {
+    Eigen::Isometry3d base_tf;
+    base_tf.setIdentity();
+    base_tf.translation() = Eigen::Vector3d(map.toWorldX(x0), map.toWorldY(y0), 0.13);
+    tesseract_collision::ContactResultMap contact_results;
+    contact_manager->enableCollisionObject("base_link");
+    if (!isEmptyCell(contact_manager, "base_link", base_tf, contact_results))
+      block(x0, y0);
+    contact_manager->disableCollisionObject("base_link");
+    return;
+  }
+
+  int size = 1 << level;
+  double half_span = (size - 1) * map.step_size / 2.0;
+  Eigen::Vector3d center =
+      Eigen::Vector3d(map.toWorldX(x0) + half_span, map.toWorldY(y0) + half_span, 0) + probes.offset;
+
+  const std::string& free_probe = probes.free_probes[static_cast<std::size_t>(level)];
+  if (!isProbeInContact(contact_manager, acm, free_probe, center))
+    return;
+
+  const std::string& core_probe = probes.core_probes[static_cast<std::size_t>(level)];
+  if (!core_probe.empty() && isProbeInContact(contact_manager, acm, core_probe, center))
+  {
+    for (int y = y0; y < std::min(y0 + size, map.grid_size_y); ++y)
+    {
+      for (int x = x0; x < std::min(x0 + size, map.grid_size_x); ++x)
+        block(x, y);
+    }
+    return;
+  }
+
+  int half = size / 2;
+  checkGridBlock(contact_manager, probes, acm, map, x0, y0, level - 1, cells);
+  checkGridBlock(contact_manager, probes, acm, map, x0 + half, y0, level - 1, cells);
+  checkGridBlock(contact_manager, probes, acm, map, x0, y0 + half, level - 1, cells);
+  checkGridBlock(contact_manager, probes, acm, map, x0 + half, y0 + half, level - 1, cells);
+}
+
+/**
+ * @brief Build the base grid from contact tests with base_link, for scenes that cannot be rasterised.
+ * The grid is covered by a quadtree of square blocks: free floor and the inside of furniture are
+ * settled per block with one query, and only blocks along obstacle boundaries are subdivided down to
+ * single cells, so the number of queries grows with the obstacle perimeter rather than the floor area.
+ * Top level blocks are spread over n_threads workers, each with its own copy of the contact manager.
+ * @param n_threads Number of workers, 0 for one per hardware thread
+ */
+void buildBaseGridByContact(VKCEnvBasic& env, MapInfo& map, AStar::Generator& astar_generator, int n_threads = 0)
+{
+  const int max_level = 4;
+  std::string base_link_name = "base_link";
+
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
   tesseract_collision::DiscreteContactManager::Ptr discrete_contact_manager_ =
-      env.getVKCEnv()->getTesseract()->getEnvironment()->getDiscreteContactManager()->clone();
+      environment->getDiscreteContactManager()->clone();
 
   std::vector<std::string> link_names =
       env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
@@ -86,52 +238,634 @@ void initBaseTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pos
     }
   }
 
-  AStar::Generator astar_generator;
+  // without a footprint only single cells can be tested
+  FloorShape footprint;
+  GridBlockProbes probes;
+  if (getBaseFootprint(*environment, base_link_name, footprint))
+    probes = addGridBlockProbes(discrete_contact_manager_, footprint, map, max_level);
+  else
+    probes.max_level = 0;
+  discrete_contact_manager_->disableCollisionObject(base_link_name);
+  tesseract_scene_graph::AllowedCollisionMatrix::ConstPtr acm = environment->getAllowedCollisionMatrix();
+
+  int block_size = 1 << probes.max_level;
+  int blocks_x = (map.grid_size_x + block_size - 1) / block_size;
+  int blocks_y = (map.grid_size_y + block_size - 1) / block_size;
+  int n_blocks = blocks_x * blocks_y;
+
+  if (n_threads <= 0)
+    n_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  n_threads = std::min(n_threads, n_blocks);
+
+  // workers write disjoint cells of the shared map, blocks are interleaved to balance cluttered areas
+  AStar::CollisionMap cells(static_cast<std::size_t>(map.grid_size_x) * static_cast<std::size_t>(map.grid_size_y), 0);
+  auto check_blocks = [&](int first_block, tesseract_collision::DiscreteContactManager::Ptr contact_manager) {
+    for (int i = first_block; i < n_blocks; i += n_threads)
+    {
+      checkGridBlock(contact_manager, probes, *acm, map, (i % blocks_x) * block_size, (i / blocks_x) * block_size,
+                     probes.max_level, cells);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 1; i < n_threads; ++i)
+    workers.emplace_back(check_blocks, i, discrete_contact_manager_->clone());
+  check_blocks(0, discrete_contact_manager_);
+  for (auto& worker : workers)
+    worker.join();
+
   astar_generator.setWorldSize({ map.grid_size_x, map.grid_size_y });
+  astar_generator.swapCollisionMap(cells);
+}
+
+/**
+ * @brief Build the base grid by rasterising the scene geometry, contact testing every cell only if
+ * the scene has shapes that cannot be rasterised.
+ */
+void buildBaseGrid(VKCEnvBasic& env, MapInfo& map, AStar::Generator& astar_generator, int n_threads = 0)
+{
+  if (rasteriseBaseGrid(env, map, astar_generator))
+    return;
+
+  ROS_WARN("Scene geometry cannot be rasterised, building the base grid from contact tests.");
+  buildBaseGridByContact(env, map, astar_generator, n_threads);
+}
+
+/**
+ * @brief Reuse the base grid of an unchanged scene if one is cached, otherwise update the cached
+ * incremental grid of the map layout with the links that moved and cache the result.
+ */
+void buildBaseGrid(VKCEnvBasic& env, MapInfo& map, AStar::Generator& astar_generator, BaseGridCache* grid_cache,
+                   int n_threads)
+{
+  if (grid_cache == nullptr)
+  {
+    buildBaseGrid(env, map, astar_generator, n_threads);
+    return;
+  }
+
+  BaseGridCache::Key key = BaseGridCache::makeKey(env, map);
+  if (grid_cache->lookup(key, astar_generator))
+    return;
+
+  if (!grid_cache->rasterise(env, map, astar_generator))
+  {
+    ROS_WARN("Scene geometry cannot be rasterised, building the base grid from contact tests.");
+    buildBaseGridByContact(env, map, astar_generator, n_threads);
+  }
+  grid_cache->store(key, astar_generator);
+}
+
+/**
+ * @brief Search the floor grid for a base path to the last pose of base_pose, which is replaced by the path.
+ * @return False if the goal cannot be reached, base_pose then holds the path to the closest cell explored
+ */
+bool searchBaseTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, MapInfo& map,
+                          AStar::Generator& astar_generator)
+{
+  std::string base_link_name = "base_link";
+
+  Eigen::Isometry3d base_start = env.getVKCEnv()->getTesseract()->getEnvironment()->getLinkTransform(base_link_name);
+  Eigen::Isometry3d base_end = base_pose.back().tf;
+
+  int base_x = map.toGridX(base_start.translation()[0]);
+  int base_y = map.toGridY(base_start.translation()[1]);
+
+  int end_x = map.toGridX(base_end.translation()[0]);
+  int end_y = map.toGridY(base_end.translation()[1]);
+
+  // the base may start or stop close to obstacles, never block its own start and goal cells
+  astar_generator.removeCollision({ base_x, base_y });
+  astar_generator.removeCollision({ end_x, end_y });
+
   astar_generator.setHeuristic(AStar::Heuristic::euclidean);
-  astar_generator.setDiagonalMovement(false);
+  astar_generator.setNeighbourhood(16);
+
+  base_pose.clear();
+
+  astar_generator.start({ base_x, base_y }, { end_x, end_y });
+  astar_generator.step();
+  bool found = astar_generator.isFound();
+  auto path = astar_generator.result();
+  for (auto& coordinate : path)
+  {
+    Eigen::Isometry3d base_target;
+    base_target.setIdentity();
+    base_target.translation() = Eigen::Vector3d(map.toWorldX(coordinate.x), map.toWorldY(coordinate.y), 0.13);
+    base_pose.push_back(LinkDesiredPose(base_link_name, base_target));
+  }
+  return found;
+}
+
+/**
+ * @brief Shorten a base path found on the grid by replacing parts of it with straight segments.
+ * A greedy pass first joins every waypoint to the farthest one it sees, then random shortcuts between
+ * points along the path cut the remaining corners, until they stop paying off or the time budget runs out.
+ * Segments are only accepted if every grid cell they pass through is free, so the path stays as valid as
+ * the search result. The shortcuts are drawn from a fixed seed, so a path is shortened the same way on every run
+ * that gets through the same number of tries.
+ * @param astar_generator Generator holding the grid the path was found on
+ * @param time_budget Seconds spent at most, 0 leaves the path unchanged
+ */
+void shortcutBasePath(std::vector<LinkDesiredPose>& base_pose, const MapInfo& map, AStar::Generator& astar_generator,
+                      double time_budget)
+{
+  if (time_budget <= 0 || base_pose.size() < 3)
+    return;
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(time_budget);
+  auto timed_out = [&]() { return std::chrono::steady_clock::now() > deadline; };
+
+  AStar::CoordinateList path;
+  for (auto& pose : base_pose)
+    path.push_back({ map.toGridX(pose.tf.translation()[0]), map.toGridY(pose.tf.translation()[1]) });
 
-  for (int x = 0; x < map.grid_size_x; ++x)
+  // greedy: from each kept waypoint, jump to the farthest waypoint in sight
+  AStar::CoordinateList greedy(1, path.front());
+  std::size_t current = 0;
+  while (current + 1 < path.size())
   {
-    for (int y = 0; y < map.grid_size_y; ++y)
+    std::size_t next = current + 1;
+    for (std::size_t candidate = path.size() - 1; candidate > current + 1 && !timed_out(); --candidate)
     {
-      base_tf.setIdentity();
-      contact_results.clear();
-      base_tf.translation() = Eigen::Vector3d(-map_x / 2.0 + x * step_size, -map_y / 2.0 + y * step_size, 0.13);
-      if (!isEmptyCell(discrete_contact_manager_, base_link_name, base_tf, contact_results) && (!(x == base_x && y == base_y) && !(x == end_x && y == end_y)))
-      {
-        // std::cout << "o";
-        // std::cout << x << ":\t" << y << std::endl;
-        astar_generator.addCollision({ x, y });
-      }
-      else if (x == base_x && y == base_y)
-      {
-        // std::cout << "S";
-      }
-      else if (x == end_x && y == end_y)
+      if (astar_generator.isSegmentFree(path[current], path[candidate]))
       {
-        // std::cout << "G";
+        next = candidate;
+        break;
       }
-      else
+    }
+    greedy.push_back(path[next]);
+    current = next;
+  }
+  path.swap(greedy);
+
+  auto distance = [](const AStar::Vec2i& a, const AStar::Vec2i& b) { return std::hypot(b.x - a.x, b.y - a.y); };
+  auto point_at = [&](std::size_t segment, double t) -> AStar::Vec2i {
+    return { static_cast<int>(std::lround(path[segment].x + t * (path[segment + 1].x - path[segment].x))),
+             static_cast<int>(std::lround(path[segment].y + t * (path[segment + 1].y - path[segment].y))) };
+  };
+
+  // random: join two points on different segments if that is shorter and free, until it stops paying off
+  std::minstd_rand random;
+  std::uniform_real_distribution<double> fraction(0.0, 1.0);
+  int failures = 0;
+  while (path.size() > 2 && failures < 200 && !timed_out())
+  {
+    ++failures;
+    std::uniform_int_distribution<std::size_t> segment(0, path.size() - 2);
+    std::size_t first = segment(random);
+    std::size_t second = segment(random);
+    if (first == second)
+      continue;
+    if (first > second)
+      std::swap(first, second);
+
+    AStar::Vec2i a = point_at(first, fraction(random));
+    AStar::Vec2i b = point_at(second, fraction(random));
+
+    // points are rounded to cells, so the pieces back to the path are checked as well
+    double along = distance(a, path[first + 1]) + distance(path[second], b);
+    for (std::size_t k = first + 1; k < second; ++k)
+      along += distance(path[k], path[k + 1]);
+    if (distance(a, b) >= along - 1e-6 || !astar_generator.isSegmentFree(path[first], a) ||
+        !astar_generator.isSegmentFree(a, b) || !astar_generator.isSegmentFree(b, path[second + 1]))
+      continue;
+
+    AStar::CoordinateList shortened(path.begin(), path.begin() + static_cast<long>(first) + 1);
+    shortened.push_back(a);
+    shortened.push_back(b);
+    shortened.insert(shortened.end(), path.begin() + static_cast<long>(second) + 1, path.end());
+    // a point on a waypoint would repeat it
+    shortened.erase(std::unique(shortened.begin(), shortened.end()), shortened.end());
+    path.swap(shortened);
+    failures = 0;
+  }
+
+  std::string base_link_name = base_pose.front().link_name;
+  base_pose.clear();
+  for (auto& coordinate : path)
+  {
+    Eigen::Isometry3d base_target;
+    base_target.setIdentity();
+    base_target.translation() = Eigen::Vector3d(map.toWorldX(coordinate.x), map.toWorldY(coordinate.y), 0.13);
+    base_pose.push_back(LinkDesiredPose(base_link_name, base_target));
+  }
+}
+
+/**
+ * @brief Search for a base path that may turn the base, for passages it only fits through at an angle.
+ * The path arrives at the heading of the last pose of base_pose, which is replaced by the path.
+ * @param swept_shapes Floor the base has to keep clear of in addition to the scene, e.g. the sweep of a door
+ * @return False if the scene cannot be rasterised or the goal cannot be reached, base_pose is then unchanged
+ */
+bool searchBaseTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, MapInfo& map,
+                          int heading_count, const std::vector<FloorShape>* swept_shapes = nullptr)
+{
+  std::string base_link_name = "base_link";
+
+  HeadingGrid heading_grid(map, heading_count);
+  if (!heading_grid.build(env, swept_shapes != nullptr ? *swept_shapes : std::vector<FloorShape>()))
+    return false;
+
+  Eigen::Isometry3d base_start = env.getVKCEnv()->getTesseract()->getEnvironment()->getLinkTransform(base_link_name);
+  Eigen::Isometry3d base_end = base_pose.back().tf;
+  Eigen::Vector3d start_axis = base_start.rotation() * Eigen::Vector3d::UnitX();
+  Eigen::Vector3d end_axis = base_end.rotation() * Eigen::Vector3d::UnitX();
+
+  HeadingGrid::State start{ map.toGridX(base_start.translation()[0]), map.toGridY(base_start.translation()[1]),
+                            heading_grid.toHeading(std::atan2(start_axis.y(), start_axis.x())) };
+  HeadingGrid::Path path;
+  if (!heading_grid.findPath(start, map.toGridX(base_end.translation()[0]), map.toGridY(base_end.translation()[1]),
+                             heading_grid.toHeading(std::atan2(end_axis.y(), end_axis.x())), path))
+    return false;
+
+  // same goal to start order as the grid search, initTrajectory reverses it
+  base_pose.clear();
+  for (auto it = path.rbegin(); it != path.rend(); ++it)
+  {
+    Eigen::Isometry3d base_target;
+    base_target.setIdentity();
+    base_target.translation() = Eigen::Vector3d(map.toWorldX(it->x), map.toWorldY(it->y), 0.13);
+    base_target.linear() =
+        Eigen::AngleAxisd(heading_grid.getHeadingAngle(it->heading), Eigen::Vector3d::UnitZ()).toRotationMatrix();
+    base_pose.push_back(LinkDesiredPose(base_link_name, base_target));
+  }
+  return true;
+}
+
+/** @brief A* costs of the cells of the distance field, see setClearanceCosts(). */
+void computeClearanceCosts(const FloorDistanceField& distance_field, AStar::CostMap& costs)
+{
+  // cells next to obstacles cost as much as two more steps, from 0.3 m beyond the base corners on nothing
+  distance_field.getClearanceCosts(distance_field.getBaseInscribedRadius(),
+                                   distance_field.getBaseCircumscribedRadius() + 0.3, 20, costs);
+}
+
+/**
+ * @brief Make the A* search prefer cells with room around the base, so that base paths keep away from
+ * walls and furniture where the grid alone would let them graze past.
+ */
+void setClearanceCosts(const FloorDistanceField& distance_field, AStar::Generator& astar_generator)
+{
+  AStar::CostMap costs;
+  computeClearanceCosts(distance_field, costs);
+  astar_generator.swapCostMap(costs);
+}
+
+/**
+ * @brief Block the cells in which the base would touch any of the shapes, e.g. the floor swept by a door
+ * the robot is opening, which the scene itself does not show as an obstacle.
+ * Cells in which the base would overlap the floor it stands on stay free, see rasteriseSweptShapes().
+ */
+void blockFloorShapes(VKCEnvBasic& env, const std::vector<FloorShape>& shapes, const MapInfo& map,
+                      AStar::Generator& astar_generator)
+{
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  FloorShape footprint;
+  if (shapes.empty() || !getBaseFootprint(*environment, "base_link", footprint))
+    return;
+
+  std::vector<std::size_t> cells;
+  rasteriseSweptShapes(shapes, footprint, placeFootprint(footprint, environment->getLinkTransform("base_link")), map,
+                       cells);
+  std::size_t width = static_cast<std::size_t>(map.grid_size_x);
+  for (auto cell : cells)
+    astar_generator.addCollision({ static_cast<int>(cell % width), static_cast<int>(cell / width) });
+}
+
+/**
+ * @brief Search a coarse grid first and refine the path on a fine grid that only covers a corridor around it.
+ * The fine grid is searched on the bounds of the corridor only, which are a small part of the map for most
+ * paths, while the path keeps the fine resolution where it passes close to furniture.
+ * With a grid cache the corridor is cropped from the cached grid of the whole fine map, which is built once
+ * per scene state; without one only the bounds of the corridor are built.
+ * @param map Fine map, also the extent of the coarse one
+ * @param context The base grid receives the fine corridor grid, the grid cache is used for both grids
+ * @param distance_field If given, the fine grid gets the same clearance costs as a search on the whole map
+ * @param coarse_step Cell size of the coarse grid
+ * @param corridor_width Distance from the coarse path up to which the fine grid is searched
+ * @return False if either search fails, base_pose is then unchanged
+ */
+bool searchBaseTrajectoryCoarseToFine(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, const MapInfo& map,
+                                      const TrajInitOptions& options, const TrajInitContext& context,
+                                      const FloorDistanceField* distance_field = nullptr, double coarse_step = 0.2,
+                                      double corridor_width = 0.5)
+{
+  TrajInitStats* stats = context.stats;
+  MapInfo coarse_map = MapInfo::fromBounds(map.origin_x, map.origin_y, map.origin_x + map.map_x,
+                                           map.origin_y + map.map_y, coarse_step);
+  AStar::Generator coarse_generator;
+  StageTimer coarse_grid_timer(stats, TrajInitStats::GRID);
+  buildBaseGrid(env, coarse_map, coarse_generator, context.grid_cache, options.grid_threads);
+  if (context.swept_shapes != nullptr)
+    blockFloorShapes(env, *context.swept_shapes, coarse_map, coarse_generator);
+  coarse_grid_timer.stop();
+
+  std::vector<LinkDesiredPose> coarse_path(1, base_pose.back());
+  StageTimer coarse_search_timer(stats, TrajInitStats::SEARCH);
+  if (!searchBaseTrajectory(env, coarse_path, coarse_map, coarse_generator))
+    return false;
+  coarse_search_timer.stop();
+
+  StageTimer fine_grid_timer(stats, TrajInitStats::GRID);
+  // exact start and goal, the coarse path only gets close to them
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  FloorPolygon corridor;
+  corridor.push_back(environment->getLinkTransform("base_link").translation().head<2>());
+  for (auto& pose : coarse_path)
+    corridor.push_back(pose.tf.translation().head<2>());
+  corridor.push_back(base_pose.back().tf.translation().head<2>());
+
+  // snapped to the same lattice as map, so that every cell of the fine map is a cell of map
+  Eigen::AlignedBox2d bounds;
+  for (auto& point : corridor)
+    bounds.extend(point);
+  MapInfo fine_map =
+      MapInfo::fromBounds(bounds.min().x() - corridor_width, bounds.min().y() - corridor_width,
+                          bounds.max().x() + corridor_width, bounds.max().y() + corridor_width, map.step_size);
+
+  // cells outside the corridor stay blocked, so that the search never leaves it
+  std::vector<bool> inside(static_cast<std::size_t>(fine_map.grid_size_x) * static_cast<std::size_t>(fine_map.grid_size_y),
+                           false);
+  int reach = static_cast<int>(std::ceil(corridor_width / fine_map.step_size));
+  for (std::size_t i = 1; i < corridor.size(); ++i)
+  {
+    const Eigen::Vector2d& a = corridor[i - 1];
+    const Eigen::Vector2d& b = corridor[i];
+    int x_first = std::max(0, std::min(fine_map.toGridX(a.x()), fine_map.toGridX(b.x())) - reach);
+    int x_last = std::min(fine_map.grid_size_x - 1, std::max(fine_map.toGridX(a.x()), fine_map.toGridX(b.x())) + reach);
+    int y_first = std::max(0, std::min(fine_map.toGridY(a.y()), fine_map.toGridY(b.y())) - reach);
+    int y_last = std::min(fine_map.grid_size_y - 1, std::max(fine_map.toGridY(a.y()), fine_map.toGridY(b.y())) + reach);
+    double length_2 = (b - a).squaredNorm();
+    for (int y = y_first; y <= y_last; ++y)
+    {
+      for (int x = x_first; x <= x_last; ++x)
       {
-        // std::cout << "+";
+        Eigen::Vector2d cell(fine_map.toWorldX(x), fine_map.toWorldY(y));
+        double t = length_2 > 0 ? std::min(1.0, std::max(0.0, (cell - a).dot(b - a) / length_2)) : 0.0;
+        if ((a + t * (b - a) - cell).norm() <= corridor_width)
+          inside[static_cast<std::size_t>(y * fine_map.grid_size_x + x)] = true;
       }
     }
-    // std::cout << "" << std::endl;
   }
 
+  AStar::Generator source_generator;
+  MapInfo source_map = fine_map;
+  if (context.grid_cache != nullptr)
+  {
+    source_map = map;
+    buildBaseGrid(env, source_map, source_generator, context.grid_cache, options.grid_threads);
+  }
+  else
+  {
+    buildBaseGrid(env, source_map, source_generator, options.grid_threads);
+  }
+
+  AStar::CostMap source_costs;
+  MapInfo costs_map = fine_map;
+  if (distance_field != nullptr && !distance_field->empty() &&
+      std::abs(distance_field->getMapInfo().step_size - fine_map.step_size) < 1e-9)
+  {
+    computeClearanceCosts(*distance_field, source_costs);
+    costs_map = distance_field->getMapInfo();
+  }
+
+  // copy the corridor cells and their costs over, the sources may cover more floor than the fine map
+  const AStar::CollisionMap& source_cells = source_generator.getCollisionMap();
+  std::size_t n_cells = static_cast<std::size_t>(fine_map.grid_size_x) * static_cast<std::size_t>(fine_map.grid_size_y);
+  AStar::CollisionMap fine_cells(n_cells, 100);
+  AStar::CostMap fine_costs(source_costs.empty() ? 0 : n_cells, 0);
+  int cells_x = source_map.toGridX(fine_map.origin_x);
+  int cells_y = source_map.toGridY(fine_map.origin_y);
+  int costs_x = costs_map.toGridX(fine_map.origin_x);
+  int costs_y = costs_map.toGridY(fine_map.origin_y);
+  for (int y = 0; y < fine_map.grid_size_y; ++y)
+  {
+    for (int x = 0; x < fine_map.grid_size_x; ++x)
+    {
+      std::size_t cell = static_cast<std::size_t>(y * fine_map.grid_size_x + x);
+      if (!inside[cell])
+        continue;
+      int source_x = x + cells_x;
+      int source_y = y + cells_y;
+      if (source_x >= 0 && source_y >= 0 && source_x < source_map.grid_size_x && source_y < source_map.grid_size_y)
+        fine_cells[cell] = source_cells[static_cast<std::size_t>(source_y * source_map.grid_size_x + source_x)];
+      source_x = x + costs_x;
+      source_y = y + costs_y;
+      if (!fine_costs.empty() && source_x >= 0 && source_y >= 0 && source_x < costs_map.grid_size_x &&
+          source_y < costs_map.grid_size_y)
+        fine_costs[cell] = source_costs[static_cast<std::size_t>(source_y * costs_map.grid_size_x + source_x)];
+    }
+  }
+
+  AStar::Generator fine_generator;
+  fine_generator.setWorldSize({ fine_map.grid_size_x, fine_map.grid_size_y });
+  fine_generator.swapCollisionMap(fine_cells);
+  fine_generator.swapCostMap(fine_costs);
+  if (context.swept_shapes != nullptr)
+    blockFloorShapes(env, *context.swept_shapes, fine_map, fine_generator);
+  fine_grid_timer.stop();
+
+  std::vector<LinkDesiredPose> fine_path(1, base_pose.back());
+  StageTimer fine_search_timer(stats, TrajInitStats::SEARCH);
+  if (!searchBaseTrajectory(env, fine_path, fine_map, fine_generator))
+    return false;
+  shortcutBasePath(fine_path, fine_map, fine_generator, options.shortcut_time);
+  fine_search_timer.stop();
+
+  base_pose = fine_path;
+  if (context.base_grid != nullptr)
+  {
+    exportOccupancyGrid(fine_generator, fine_map, *context.base_grid);
+  }
+  return true;
+}
+
+/**
+ * @brief Search a base path on the roadmap of the environment, reusing the collision checks of earlier queries.
+ * @return False if the roadmap cannot connect start and goal, base_pose is unchanged then
+ */
+bool searchBaseRoadmap(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, BaseRoadmap& roadmap)
+{
+  std::string base_link_name = "base_link";
+
+  Eigen::Isometry3d base_start = env.getVKCEnv()->getTesseract()->getEnvironment()->getLinkTransform(base_link_name);
+  Eigen::Isometry3d base_end = base_pose.back().tf;
+
+  BaseRoadmap::Path path;
+  if (!roadmap.findPath(base_start.translation().head<2>(), base_end.translation().head<2>(), path))
+    return false;
+
+  // same goal to start order as the grid search, initTrajectory reverses it
   base_pose.clear();
+  for (auto it = path.rbegin(); it != path.rend(); ++it)
+  {
+    Eigen::Isometry3d base_target;
+    base_target.setIdentity();
+    base_target.translation() = Eigen::Vector3d(it->x(), it->y(), 0.13);
+    base_pose.push_back(LinkDesiredPose(base_link_name, base_target));
+  }
+  return true;
+}
 
-  auto path = astar_generator.findPath({ base_x, base_y }, { end_x, end_y });
-  for (auto& coordinate : path)
+/**
+ * @brief Search a base path on a prebuilt visibility graph instead of a floor grid.
+ * Only suited to scenes whose obstacles are boxes, see VisibilityGraph.
+ * @return False if the goal cannot be reached on the graph, base_pose is left unchanged then
+ */
+bool searchVisibilityGraph(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, const VisibilityGraph& graph)
+{
+  std::string base_link_name = "base_link";
+
+  Eigen::Isometry3d base_start = env.getVKCEnv()->getTesseract()->getEnvironment()->getLinkTransform(base_link_name);
+  Eigen::Isometry3d base_end = base_pose.back().tf;
+
+  VisibilityGraph::Polygon path;
+  if (!graph.findPath(base_start.translation().head<2>(), base_end.translation().head<2>(), path))
+    return false;
+
+  // same goal to start order as the grid search, initTrajectory reverses it
+  base_pose.clear();
+  for (auto it = path.rbegin(); it != path.rend(); ++it)
   {
     Eigen::Isometry3d base_target;
     base_target.setIdentity();
-    base_target.translation() =
-        Eigen::Vector3d(-map_x / 2.0 + coordinate.x * step_size, -map_y / 2.0 + coordinate.y * step_size, 0.13);
+    base_target.translation() = Eigen::Vector3d(it->x(), it->y(), 0.13);
     base_pose.push_back(LinkDesiredPose(base_link_name, base_target));
   }
-  return;
+  return true;
+}
+
+/**
+ * @brief Search a base path on an externally provided floor grid, e.g. from a map server.
+ * The cells are lent to the search without copying and handed back unchanged afterwards: the start and
+ * goal cells the search clears are restored, and a grid that does not match the map is not touched at all.
+ * @return False if the grid does not match the map, does not contain the start and goal, or has no path.
+ */
+bool searchOccupancyGrid(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, MapInfo& map,
+                         nav_msgs::OccupancyGrid& base_grid)
+{
+  // the cells searchBaseTrajectory() clears, the goal is the last pose before the path replaces it
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  Eigen::Vector3d base_start = environment->getLinkTransform("base_link").translation();
+  Eigen::Vector3d base_end = base_pose.back().tf.translation();
+  if (!map.contains(base_start.x(), base_start.y()) || !map.contains(base_end.x(), base_end.y()))
+    return false;
+
+  AStar::Generator astar_generator;
+  if (!importOccupancyGrid(base_grid, map, astar_generator))
+    return false;
+
+  std::vector<std::pair<std::size_t, std::int8_t>> cleared;
+  for (const Eigen::Vector3d& position : { base_start, base_end })
+  {
+    int x = map.toGridX(position.x());
+    int y = map.toGridY(position.y());
+    std::size_t cell =
+        static_cast<std::size_t>(y) * static_cast<std::size_t>(map.grid_size_x) + static_cast<std::size_t>(x);
+    cleared.push_back(std::make_pair(cell, astar_generator.getCollisionMap()[cell]));
+  }
+
+  std::vector<LinkDesiredPose> path_pose = base_pose;
+  bool found = searchBaseTrajectory(env, path_pose, map, astar_generator);
+  exportOccupancyGrid(astar_generator, map, base_grid);
+  for (const auto& cell : cleared)
+    base_grid.data[cell.first] = cell.second;
+
+  if (found)
+    base_pose = path_pose;
+  return found;
+}
+
+/**
+ * @brief Plan a base path on a freshly built floor grid.
+ * With use_base_roadmap set in options, the roadmap of the environment is searched first unless the context
+ * has swept shapes, which the roadmap does not know; no grid is built then.
+ * With use_visibility_graph set, the visibility graph of the environment is searched next under the same
+ * condition, unless the scene has obstacles it cannot represent.
+ * An input grid of the context is searched next under the same condition, see searchOccupancyGrid().
+ * With coarse_to_fine set in options, a coarse grid is searched first and the fine one only around its path,
+ * see searchBaseTrajectoryCoarseToFine(); the full fine grid is still searched if that fails.
+ * Swept shapes of the context are blocked on every grid, leaving out the floor the base currently stands on.
+ * @param context The base grid receives the grid used for the search (e.g. for publishing), if one was built
+ * @param distance_field If given and built on the same map, keeps the path away from obstacles.
+ */
+void initBaseTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>& base_pose, MapInfo& map,
+                        const TrajInitOptions& options = TrajInitOptions(),
+                        const TrajInitContext& context = TrajInitContext(),
+                        const FloorDistanceField* distance_field = nullptr)
+{
+  TrajInitStats* stats = context.stats;
+  if (options.use_base_roadmap && (context.swept_shapes == nullptr || context.swept_shapes->empty()))
+  {
+    StageTimer search_timer(stats, TrajInitStats::SEARCH);
+    BaseRoadmap::Ptr roadmap = env.getBaseRoadmap();
+    if (roadmap != nullptr && searchBaseRoadmap(env, base_pose, *roadmap))
+      return;
+    ROS_DEBUG("No base path found on the roadmap, searching the floor grid.");
+  }
+
+  if (options.use_visibility_graph && (context.swept_shapes == nullptr || context.swept_shapes->empty()))
+  {
+    StageTimer search_timer(stats, TrajInitStats::SEARCH);
+    VisibilityGraph::Ptr graph = env.getVisibilityGraph();
+    if (graph != nullptr && searchVisibilityGraph(env, base_pose, *graph))
+      return;
+    ROS_DEBUG("No base path found on the visibility graph, searching the floor grid.");
+  }
+
+  if (context.input_grid != nullptr && !context.input_grid->data.empty() &&
+      (context.swept_shapes == nullptr || context.swept_shapes->empty()))
+  {
+    StageTimer search_timer(stats, TrajInitStats::SEARCH);
+    if (searchOccupancyGrid(env, base_pose, map, *context.input_grid))
+      return;
+    ROS_DEBUG("No base path found on the given floor grid, building one from the scene.");
+  }
+
+  // grow the map rather than clamping a start or goal outside it to the edge
+  Eigen::Vector3d base_start = env.getVKCEnv()->getTesseract()->getEnvironment()->getLinkTransform("base_link").translation();
+  Eigen::Vector3d base_end = base_pose.back().tf.translation();
+  if (!map.contains(base_start.x(), base_start.y()) || !map.contains(base_end.x(), base_end.y()))
+  {
+    ROS_DEBUG("Base start or goal outside of the floor map, growing it.");
+    map.extend(base_start.x(), base_start.y(), 0.5);
+    map.extend(base_end.x(), base_end.y(), 0.5);
+  }
+
+  // a coarse grid only pays off on fine maps
+  if (options.coarse_to_fine && map.step_size <= 0.1 &&
+      searchBaseTrajectoryCoarseToFine(env, base_pose, map, options, context, distance_field))
+    return;
+
+  AStar::Generator astar_generator;
+  StageTimer grid_timer(stats, TrajInitStats::GRID);
+  buildBaseGrid(env, map, astar_generator, context.grid_cache, options.grid_threads);
+  if (context.swept_shapes != nullptr)
+    blockFloorShapes(env, *context.swept_shapes, map, astar_generator);
+  if (distance_field != nullptr && !distance_field->empty() && distance_field->getMapInfo() == map)
+  {
+    setClearanceCosts(*distance_field, astar_generator);
+  }
+  grid_timer.stop();
+
+  // the grid only knows the base without rotation, turning it may open narrow passages
+  std::vector<LinkDesiredPose> goal_pose(1, base_pose.back());
+  StageTimer search_timer(stats, TrajInitStats::SEARCH);
+  if (searchBaseTrajectory(env, base_pose, map, astar_generator))
+  {
+    shortcutBasePath(base_pose, map, astar_generator, options.shortcut_time);
+  }
+  else if (searchBaseTrajectory(env, goal_pose, map, 16, context.swept_shapes))
+  {
+    base_pose = goal_pose;
+  }
+  search_timer.stop();
+
+  if (context.base_grid != nullptr)
+  {
+    exportOccupancyGrid(astar_generator, map, *context.base_grid);
+  }
 }
 
 void initFinalJointSeed(std::unordered_map<std::string, int>& joint_name_idx,
@@ -169,32 +903,296 @@ bool checkJointLimit(Eigen::VectorXd& sol, const Eigen::MatrixX2d& joint_limit,
   return true;
 }
 
-double interpolate(std::vector<LinkDesiredPose> base_pose, std::vector<double> remap, int i, bool x){
-  double idx = remap[i];
+/**
+ * @brief Base rotation about z at step i of the remapped base path, continuous with the previous step.
+ */
+double interpolateHeading(const std::vector<LinkDesiredPose>& base_pose, const std::vector<double>& remap, int i,
+                          double previous)
+{
   double idx_1 = 0;
-  double rem = modf(idx , &idx_1);
-  double idx_2 = idx_1 + 1;
-  double waypts_len = pow(pow(base_pose[int(idx_2)].tf.translation()[0] - base_pose[int(idx_1)].tf.translation()[0], 2.0) + 
-                          pow(base_pose[int(idx_2)].tf.translation()[1] - base_pose[int(idx_1)].tf.translation()[1], 2.0), 0.5);
-  double grad_x = (base_pose[int(idx_2)].tf.translation()[0] - base_pose[int(idx_1)].tf.translation()[0])/waypts_len;
-  double grad_y = (base_pose[int(idx_2)].tf.translation()[1] - base_pose[int(idx_1)].tf.translation()[1])/waypts_len;
-
-  if (x)
-    return base_pose[int(idx_1)].tf.translation()[0] + grad_x * rem * waypts_len;
-  else
-    return base_pose[int(idx_1)].tf.translation()[1] + grad_y * rem * waypts_len;
+  double rem = modf(remap[i], &idx_1);
+  std::size_t first = static_cast<std::size_t>(idx_1);
+  std::size_t second = std::min(first + 1, base_pose.size() - 1);
+
+  Eigen::Vector3d axis_1 = base_pose[first].tf.rotation() * Eigen::Vector3d::UnitX();
+  Eigen::Vector3d axis_2 = base_pose[second].tf.rotation() * Eigen::Vector3d::UnitX();
+  double angle_1 = std::atan2(axis_1.y(), axis_1.x());
+  double angle_2 = angle_1 + std::remainder(std::atan2(axis_2.y(), axis_2.x()) - angle_1, 2 * M_PI);
+  double angle = angle_1 + rem * (angle_2 - angle_1);
+  return previous + std::remainder(angle - previous, 2 * M_PI);
 }
 
+/**
+ * @brief Waypoint coordinates (index of a waypoint plus the fraction of the way to the next one) of n_steps
+ * points spaced evenly along the length of the base path, the first and the last at its ends.
+ * The cumulative length is computed once and the waypoints are walked in a single pass, O(n + n_steps).
+ */
+std::vector<double> remapByArcLength(const std::vector<LinkDesiredPose>& base_pose, int n_steps)
+{
+  std::vector<double> remap(static_cast<std::size_t>(std::max(n_steps, 0)), 0.0);
+  if (base_pose.size() < 2 || n_steps < 2)
+    return remap;
 
+  std::vector<double> length(base_pose.size(), 0.0);
+  for (std::size_t k = 1; k < base_pose.size(); ++k)
+    length[k] = length[k - 1] +
+                (base_pose[k].tf.translation().head<2>() - base_pose[k - 1].tf.translation().head<2>()).norm();
+
+  std::size_t segment = 0;
+  for (int i = 0; i < n_steps; ++i)
+  {
+    // a path that does not move the base is spread over its waypoints
+    if (length.back() <= 0)
+    {
+      remap[static_cast<std::size_t>(i)] = i / 1.0 / (n_steps - 1) * static_cast<double>(base_pose.size() - 1);
+      continue;
+    }
+
+    double distance = length.back() * i / (n_steps - 1);
+    while (segment + 2 < base_pose.size() && length[segment + 1] < distance)
+      ++segment;
+    double segment_length = length[segment + 1] - length[segment];
+    double fraction =
+        segment_length > 0 ? std::min(1.0, std::max(0.0, (distance - length[segment]) / segment_length)) : 0.0;
+    remap[static_cast<std::size_t>(i)] = static_cast<double>(segment) + fraction;
+  }
+  return remap;
+}
+
+/**
+ * @brief Base position at a waypoint coordinate of remapByArcLength().
+ * @param smooth Follow a Catmull-Rom spline through the waypoints, whose direction is continuous at them,
+ * instead of the straight segments between them. The spline may cut slightly into the corners of the path.
+ */
+Eigen::Vector2d interpolatePosition(const std::vector<LinkDesiredPose>& base_pose, double remap, bool smooth = false)
+{
+  double index = 0;
+  double t = modf(remap, &index);
+  std::size_t first = static_cast<std::size_t>(index);
+  std::size_t last = base_pose.size() - 1;
+  auto point = [&](std::size_t k) -> Eigen::Vector2d { return base_pose[std::min(k, last)].tf.translation().head<2>(); };
+
+  Eigen::Vector2d p1 = point(first);
+  Eigen::Vector2d p2 = point(first + 1);
+  if (!smooth)
+    return p1 + t * (p2 - p1);
+
+  // the ends of the path repeat their waypoint, so the spline still ends there
+  Eigen::Vector2d p0 = first > 0 ? point(first - 1) : p1;
+  Eigen::Vector2d p3 = point(first + 2);
+  double t2 = t * t;
+  double t3 = t2 * t;
+  return 0.5 * (2.0 * p1 + (p2 - p0) * t + (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t2 +
+                (3.0 * p1 - p0 - 3.0 * p2 + p3) * t3);
+}
+
+/**
+ * @brief Draw a random inverse kinematics seed for the given joints, the others keep their value.
+ */
+template <typename RandomEngine>
+void sampleInvKinSeed(const std::vector<int>& sampled_joints, const Eigen::MatrixX2d& joint_limits, RandomEngine& rng,
+                      Eigen::VectorXd& seed)
+{
+  for (int j : sampled_joints)
+  {
+    int upper = std::max(1, int(joint_limits(j, 1)));
+    if (j == 4 || j == 6 || j == 7)
+      seed[j] = static_cast<int>(rng() % static_cast<unsigned>(upper)) - int(0.5 * joint_limits(j, 1));
+    else
+      seed[j] = static_cast<int>(rng() % static_cast<unsigned>(2 * upper)) - upper;
+  }
+}
+
+/**
+ * @brief Try random seeds for the inverse kinematics of a target until a solution is within the joint
+ * limits and free of contacts, or max_iter seeds have been tried.
+ * Solutions go through checks of increasing cost and are rejected by the first they fail: joint limits, the
+ * base footprint in the floor distance field, contacts among the robot links (including attached objects),
+ * and finally contacts with the whole scene. Both contact tests stop at the first contact.
+ * Seeds are spread over n_threads workers, each with its own copy of the solver, the state solver of the
+ * environment and the contact managers.
+ * A worker takes the next seed as soon as it is done with one, and all of them stop once any found a
+ * valid solution, so no more seeds are tried than in a sequential search plus one per worker.
+ * @param inv_kin Solver returning one solution per seed, or several one after the other
+ * @param contact_manager Contact manager with the links to check enabled, only copied by workers
+ * @param sampled_joints Joints that get random seeds, the others are seeded from initial_seed
+ * @param n_threads Number of workers, 0 for one per hardware thread
+ * @param preferred_seeds Seeds tried before the random ones, in order, e.g. solutions of nearby targets.
+ * Only their sampled joints are used, and only those that are not NaN, the others are drawn at random.
+ * @param sol Receives the first valid solution, or initial_seed if none is valid
+ * @param stats If given, receives the time spent on inverse kinematics and collision checks, summed over workers,
+ * and the number of solutions each check rejected
+ * @return True if a valid solution was found
+ */
+bool searchInvKin(VKCEnvBasic& env, tesseract_kinematics::InverseKinematics::Ptr inv_kin,
+                  tesseract_collision::DiscreteContactManager::Ptr contact_manager,
+                  const FloorDistanceField& distance_field, const Eigen::Isometry3d& target,
+                  const Eigen::VectorXd& initial_seed, const std::vector<int>& sampled_joints, int max_iter,
+                  int n_threads, Eigen::VectorXd& sol, TrajInitStats* stats = nullptr,
+                  const std::vector<Eigen::VectorXd>& preferred_seeds = std::vector<Eigen::VectorXd>())
+{
+  tesseract_environment::Environment::ConstPtr environment = env.getVKCEnv()->getTesseract()->getEnvironmentConst();
+  std::vector<std::string> joint_names = inv_kin->getJointNames();
+  Eigen::MatrixX2d joint_limits = inv_kin->getLimits();
+  int num_joints = static_cast<int>(inv_kin->numJoints());
+
+  if (n_threads <= 0)
+    n_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  n_threads = std::max(1, std::min(n_threads, max_iter));
+
+  std::atomic<int> next_iter(0);
+  std::atomic<bool> found(false);
+  std::mutex result_mutex;
+  int tried = 0;
+  std::vector<TrajInitStats> worker_stats(static_cast<std::size_t>(n_threads));
+
+  auto search = [&](int worker, tesseract_kinematics::InverseKinematics::Ptr solver,
+                    tesseract_environment::StateSolver::Ptr state_solver,
+                    tesseract_collision::DiscreteContactManager::Ptr manager,
+                    tesseract_collision::DiscreteContactManager::Ptr self_manager, unsigned rng_seed) {
+    std::minstd_rand rng(rng_seed);
+    TrajInitStats* local_stats = stats != nullptr ? &worker_stats[static_cast<std::size_t>(worker)] : nullptr;
+    Eigen::VectorXd seed = initial_seed;
+    Eigen::VectorXd candidate = initial_seed;
+    Eigen::VectorXd solutions;
+    tesseract_collision::ContactResultMap contact_results;
+
+    // the first check a solution fails, CHECK_COUNT if it passes all of them
+    auto findRejection = [&](Eigen::VectorXd& joints) -> TrajInitStats::Check {
+      if (!checkJointLimit(joints, joint_limits, num_joints))
+        return TrajInitStats::JOINT_LIMITS;
+      if (distance_field.isBaseInCollision(Eigen::Vector2d(joints(0), joints(1))))
+        return TrajInitStats::BASE_FOOTPRINT;
+
+      tesseract_environment::EnvState::Ptr env_state = state_solver->getState(joint_names, joints);
+      contact_results.clear();
+      self_manager->setCollisionObjectsTransform(env_state->transforms);
+      self_manager->contactTest(contact_results, tesseract_collision::ContactTestType::FIRST);
+      if (!contact_results.empty())
+        return TrajInitStats::SELF_COLLISION;
+
+      manager->setCollisionObjectsTransform(env_state->transforms);
+      manager->contactTest(contact_results, tesseract_collision::ContactTestType::FIRST);
+      if (!contact_results.empty())
+        return TrajInitStats::ENVIRONMENT_CONTACT;
+      return TrajInitStats::CHECK_COUNT;
+    };
+
+    int iter = 0;
+    while (!found && (iter = next_iter++) < max_iter)
+    {
+      std::size_t preferred = static_cast<std::size_t>(iter);
+      sampleInvKinSeed(sampled_joints, joint_limits, rng, seed);
+      if (preferred < preferred_seeds.size() && preferred_seeds[preferred].size() == seed.size())
+      {
+        for (int j : sampled_joints)
+        {
+          if (!std::isnan(preferred_seeds[preferred][j]))
+            seed[j] = preferred_seeds[preferred][j];
+        }
+      }
+
+      StageTimer ik_timer(local_stats, TrajInitStats::IK);
+      bool solved = solver->calcInvKin(solutions, target, seed);
+      ik_timer.stop();
+
+      // closed form solvers return all branches one after the other, the first valid one is taken
+      bool valid = false;
+      long n_solutions = solved ? solutions.size() / num_joints : 0;
+      for (long k = 0; k < n_solutions && !valid; ++k)
+      {
+        candidate = solutions.segment(k * num_joints, num_joints);
+        StageTimer collision_timer(local_stats, TrajInitStats::COLLISION);
+        TrajInitStats::Check rejection = findRejection(candidate);
+        collision_timer.stop();
+
+        valid = rejection == TrajInitStats::CHECK_COUNT;
+        if (local_stats != nullptr)
+        {
+          ++local_stats->candidates;
+          if (!valid)
+            ++local_stats->rejections[rejection];
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(result_mutex);
+      ++tried;
+      if (found || !valid)
+        continue;
+      sol = candidate;
+      found = true;
+    }
+  };
+
+  // the robot links alone, with everything else in the scene disabled
+  StageTimer clone_timer(stats, TrajInitStats::CLONE);
+  tesseract_collision::DiscreteContactManager::Ptr self_contact_manager = contact_manager->clone();
+  std::vector<std::string> robot_links = inv_kin->getActiveLinkNames();
+  for (const auto& link_name : self_contact_manager->getCollisionObjects())
+  {
+    if (std::find(robot_links.begin(), robot_links.end(), link_name) == robot_links.end())
+      self_contact_manager->disableCollisionObject(link_name);
+  }
+
+  // the state solver of the environment is not safe to use from several threads, each worker gets a copy
+  std::vector<std::thread> workers;
+  for (int i = 1; i < n_threads; ++i)
+    workers.emplace_back(search, i, inv_kin->clone(), environment->getStateSolver(), contact_manager->clone(),
+                         self_contact_manager->clone(), static_cast<unsigned>(rand()));
+  tesseract_environment::StateSolver::Ptr state_solver = environment->getStateSolver();
+  clone_timer.stop();
+  search(0, inv_kin, state_solver, contact_manager, self_contact_manager, static_cast<unsigned>(rand()));
+  for (auto& worker : workers)
+    worker.join();
+
+  if (stats != nullptr)
+  {
+    for (const auto& local_stats : worker_stats)
+    {
+      stats->seconds[TrajInitStats::IK] += local_stats.seconds[TrajInitStats::IK];
+      stats->seconds[TrajInitStats::COLLISION] += local_stats.seconds[TrajInitStats::COLLISION];
+      stats->candidates += local_stats.candidates;
+      for (int check = 0; check < TrajInitStats::CHECK_COUNT; ++check)
+        stats->rejections[check] += local_stats.rejections[check];
+    }
+  }
+
+  if (found)
+  {
+    ROS_DEBUG("Found a valid inverse kinematics solution after %d seeds.", tried);
+  }
+  else
+  {
+    ROS_WARN("Exceed max inv kin iter!");
+    sol = initial_seed;
+  }
+  return found;
+}
+
+/**
+ * @brief Initial trajectory of the vkc group towards the link and joint objectives.
+ * @param options Settings of the base path search and of inverse kinematics
+ * @param context Caches and outputs shared across calls, and the floor swept by the action
+ */
 trajopt::TrajArray initTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>& link_objectives,
                                   std::vector<JointDesiredPose>& joint_objectives, MapInfo map,
-                                  trajopt::TrajArray& init_traj, int n_steps)
+                                  trajopt::TrajArray& init_traj, int n_steps,
+                                  const TrajInitOptions& options = TrajInitOptions(),
+                                  const TrajInitContext& context = TrajInitContext())
 {
+  TrajInitStats* stats = context.stats;
+  IKSolutionCache* ik_cache = context.ik_cache;
+  const InverseReachabilityMap* reachability_map = context.reachability_map;
+  StageTimer total_timer(stats, TrajInitStats::TOTAL);
+  if (stats != nullptr)
+    ++stats->calls;
+
   srand(time(NULL));
 
   int max_iter = 100;
 
   tesseract::InverseKinematicsManager::Ptr inv_kin_mgr = env.getVKCEnv()->getTesseract()->getInvKinematicsManager();
+  StageTimer clone_timer(stats, TrajInitStats::CLONE);
   tesseract_collision::DiscreteContactManager::Ptr disc_cont_mgr_ =
       env.getVKCEnv()->getTesseract()->getEnvironment()->getDiscreteContactManager()->clone();
 
@@ -202,6 +1200,16 @@ trajopt::TrajArray initTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>
   {
     disc_cont_mgr_->enableCollisionObject(active_link);
   }
+  clone_timer.stop();
+
+  // clearance of the floor in the current scene, to reject base poses before any contact test
+  StageTimer field_timer(stats, TrajInitStats::GRID);
+  FloorDistanceField distance_field;
+  if (!distance_field.build(env, map))
+  {
+    ROS_WARN("Scene geometry cannot be rasterised, base poses are only checked by contact tests.");
+  }
+  field_timer.stop();
 
   tesseract_collision::ContactResultMap contact_results;
   std::vector<LinkDesiredPose> base_pose;
@@ -227,10 +1235,7 @@ trajopt::TrajArray initTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>
 
   // std::cout << inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->getLimits() << std::endl;
 
-  int inv_iter = 0;
   bool inv_suc = false;
-  int satisfy_collision = 1;
-  bool satisfy_limit = false;
   bool desired_base_pose = false;
 
   if (link_objectives.size() > 0)
@@ -243,87 +1248,120 @@ trajopt::TrajArray initTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>
         base_pose.clear();
         base_pose.push_back(link_obj);
         desired_base_pose = true;
-        initBaseTrajectory(env, base_pose, map);
+        initBaseTrajectory(env, base_pose, map, options, context, &distance_field);
         initFinalJointSeed(joint_name_idx, joint_objectives, init_traj, sol);
       }
       else if (link_obj.link_name == inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->getTipLinkName())
       {
         initFinalJointSeed(joint_name_idx, joint_objectives, init_traj, seed);
 
-        Eigen::MatrixX2d joint_limits = inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->getLimits();
-        // std::cout << joint_limits << std::endl;
-
-        while (satisfy_collision > 0 || inv_iter == 0 || !inv_suc || !satisfy_limit)
+        std::vector<int> sampled_joints;
+        for (auto& jnt : joint_name_idx)
         {
-          ++inv_iter;
-
-          for (auto& jnt : joint_name_idx)
-          {
-            if (jnt.second >= 0) // jnt.second != 2 && 
-            {
-              if (jnt.second == 4 || jnt.second == 6 || jnt.second == 7 ){
-                seed[jnt.second] = rand() % (int(joint_limits(jnt.second, 1))) - int(0.5 * joint_limits(jnt.second, 1));
-              }                
-              else{
-                seed[jnt.second] = rand() % (2 * int(joint_limits(jnt.second, 1))) - int(joint_limits(jnt.second, 1));
-              }
-            }
-          }
-
-          inv_suc = inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->calcInvKin(sol, link_obj.tf, seed);
-          tesseract_environment::EnvState::Ptr env_state =
-              env.getVKCEnv()->getTesseract()->getEnvironment()->getState(joint_names, sol);
-          contact_results.clear();
-          disc_cont_mgr_->setCollisionObjectsTransform(env_state->transforms);
+          if (jnt.second >= 0)
+            sampled_joints.push_back(jnt.second);
+        }
 
-          disc_cont_mgr_->contactTest(contact_results, tesseract_collision::ContactTestType::ALL);
+        // solutions of the nearest targets solved before come first, a cached solution of the same target
+        // converges at once if the scene still lets the robot stand there
+        std::vector<Eigen::VectorXd> preferred_seeds;
+        if (ik_cache != nullptr)
+          preferred_seeds = ik_cache->getNearest(joint_names, link_obj.tf, 4, 0.2);
 
-          satisfy_collision = contact_results.size();
-          satisfy_limit = checkJointLimit(sol, inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->getLimits(),
-                                          inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->numJoints());
+        // base placements from which the arm reaches the target, best first; a target of an attached object is
+        // carried over to the end effector in the current state, which holds for objects that move with it
+        std::vector<InverseReachabilityMap::BasePlacement> placements;
+        auto getJointIndex = [&joint_names](const std::string& joint_name) -> Eigen::Index {
+          return std::find(joint_names.begin(), joint_names.end(), joint_name) - joint_names.begin();
+        };
+        Eigen::Index base_x_idx = getJointIndex("base_y_base_x");
+        Eigen::Index base_y_idx = getJointIndex("base_theta_base_y");
+        Eigen::Index base_theta_idx = getJointIndex("base_link_base_theta");
+        if (reachability_map != nullptr && !reachability_map->empty())
+        {
+          tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+          Eigen::Isometry3d arm_target = link_obj.tf * environment->getLinkTransform(link_obj.link_name).inverse() *
+                                         environment->getLinkTransform(reachability_map->getTipLinkName());
+          placements = reachability_map->getBasePlacements(
+              arm_target, environment->getLinkTransform(reachability_map->getBaseLinkName()).translation().z(), 100);
+        }
 
-          std::cout << satisfy_collision << ", " << inv_suc << ", " << satisfy_limit << std::endl;
-          if (satisfy_collision > 0) 
-          {
-            for (auto &collision : contact_results)
-            {
-              std::cout << collision.first.first << " and " << collision.first.second << " are in collision" << std::endl;
-            }
-            std::cout << "======================================================" << std::endl;
-          }
-          std::cout << "sol: " << sol.transpose() << std::endl;
-          if (inv_iter > max_iter - 1)
-          {
-            ROS_WARN("Exceed max inv kin iter!");
-            break;
-          }
+        // the best placements seed the base, the arm is still drawn at random
+        for (std::size_t i = 0; i < placements.size() && i < 8; ++i)
+        {
+          Eigen::VectorXd placement_seed =
+              Eigen::VectorXd::Constant(seed.size(), std::numeric_limits<double>::quiet_NaN());
+          if (base_x_idx < seed.size())
+            placement_seed[base_x_idx] = placements[i].x;
+          if (base_y_idx < seed.size())
+            placement_seed[base_y_idx] = placements[i].y;
+          if (base_theta_idx < seed.size())
+            placement_seed[base_theta_idx] = placements[i].theta;
+          preferred_seeds.push_back(placement_seed);
         }
-        // std::cout << "Iteration:\t" << inv_iter << std::endl;
+
+        inv_suc = searchInvKin(env, inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID), disc_cont_mgr_,
+                               distance_field, link_obj.tf, seed, sampled_joints, max_iter, options.ik_threads, sol,
+                               stats, preferred_seeds);
+        if (inv_suc && ik_cache != nullptr)
+          ik_cache->add(joint_names, link_obj.tf, sol);
         base_pose.clear();
         Eigen::Isometry3d base_final_pose;
         base_final_pose.setIdentity();
-        if (inv_suc && (satisfy_collision == 0) && (satisfy_limit == 1)){
+        if (inv_suc){
           base_final_pose.translation() = Eigen::Vector3d(sol(0), sol(1), 0.13);
+          auto theta_joint = std::find(joint_names.begin(), joint_names.end(), "base_link_base_theta");
+          if (theta_joint != joint_names.end())
+          {
+            base_final_pose.linear() =
+                Eigen::AngleAxisd(sol(theta_joint - joint_names.begin()), Eigen::Vector3d::UnitZ()).toRotationMatrix();
+          }
         }
         else{
           bool init_base_position = false;
           int idx = 0;
           std::vector<std::string> base_joints({ "base_y_base_x", "base_theta_base_y" });
           std::vector<double> base_values({ 0, 0 });
+          const InverseReachabilityMap::BasePlacement* placement = nullptr;
           while (!init_base_position && idx < 100)
           {
-            std::cout << idx << " ";
             idx += 1;
             init_base_position = true;
 
-            double r = (rand() % 100) / 100.0 * 0.7;
-            double a = (rand() % 100) / 100.0 * 6.18;
+            // ranked placements first, then positions drawn around the target
+            if (static_cast<std::size_t>(idx) <= placements.size())
+            {
+              placement = &placements[static_cast<std::size_t>(idx - 1)];
+              base_values[0] = placement->x;
+              base_values[1] = placement->y;
+            }
+            else
+            {
+              placement = nullptr;
+              double r = (rand() % 100) / 100.0 * 0.7;
+              double a = (rand() % 100) / 100.0 * 6.18;
 
-            base_values[0] = link_obj.tf.translation()[0] + r * cos(a);
-            base_values[1] = link_obj.tf.translation()[1] - r * sin(a);
+              base_values[0] = link_obj.tf.translation()[0] + r * cos(a);
+              base_values[1] = link_obj.tf.translation()[1] - r * sin(a);
+            }
 
+            StageTimer collision_timer(stats, TrajInitStats::COLLISION);
+            if (distance_field.isBaseInCollision(Eigen::Vector2d(base_values[0], base_values[1])))
+            {
+              init_base_position = false;
+              continue;
+            }
+
+            // a placement is tested with the heading it was mapped with
+            std::vector<std::string> state_joints(base_joints);
+            std::vector<double> state_values(base_values);
+            if (placement != nullptr && base_theta_idx < sol.size())
+            {
+              state_joints.push_back("base_link_base_theta");
+              state_values.push_back(placement->theta);
+            }
             tesseract_environment::EnvState::Ptr env_state =
-              env.getVKCEnv()->getTesseract()->getEnvironment()->getState(base_joints, base_values);
+              env.getVKCEnv()->getTesseract()->getEnvironment()->getState(state_joints, state_values);
             contact_results.clear();
             disc_cont_mgr_->setCollisionObjectsTransform(env_state->transforms);
             disc_cont_mgr_->contactTest(contact_results, tesseract_collision::ContactTestType::ALL);
@@ -338,9 +1376,16 @@ trajopt::TrajArray initTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>
             contact_results.clear();
             }
             base_final_pose.translation() = Eigen::Vector3d( base_values[0],  base_values[1], 0.13);
+            if (init_base_position && placement != nullptr && base_theta_idx < sol.size())
+            {
+              // the arm reaches the target from this placement only with the base turned as mapped
+              sol[base_theta_idx] = placement->theta;
+              base_final_pose.linear() =
+                  Eigen::AngleAxisd(placement->theta, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+            }
         }
         base_pose.push_back(LinkDesiredPose("base_link", base_final_pose));
-        initBaseTrajectory(env, base_pose, map);
+        initBaseTrajectory(env, base_pose, map, options, context, &distance_field);
       }
       else
       {
@@ -349,33 +1394,47 @@ trajopt::TrajArray initTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>
     }
   }
 
-  std::vector<double> nsteps_remap;
+  ROS_DEBUG_STREAM("Final joint values: " << sol.transpose());
 
-  for (int j = 0; j < inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->numJoints(); ++j)
+  std::reverse(base_pose.begin(),base_pose.end());
+  std::vector<double> nsteps_remap = remapByArcLength(base_pose, n_steps);
+
+  // a path that turns the base to get through a passage also sets the heading of the steps, offset so
+  // that it still starts and ends at the current and the final heading
+  int theta_idx = -1;
+  auto theta_joint = std::find(joint_names.begin(), joint_names.end(), "base_link_base_theta");
+  bool base_turns = std::any_of(base_pose.begin(), base_pose.end(),
+                                [](const LinkDesiredPose& pose) { return !pose.tf.rotation().isIdentity(1e-9); });
+  std::vector<double> base_heading(n_steps, 0);
+  if (base_turns && theta_joint != joint_names.end() && n_steps > 1)
   {
-    std::cout << sol[j] << ", ";
-  }
+    theta_idx = static_cast<int>(theta_joint - joint_names.begin());
+    for (int i = 0; i < n_steps; ++i)
+      base_heading[i] = interpolateHeading(base_pose, nsteps_remap, i, i == 0 ? init_traj(0, theta_idx) : base_heading[i - 1]);
 
-  for (int i = 0; i < n_steps; ++i) {
-    nsteps_remap.push_back(i/1.0/(n_steps-1)*(base_pose.size()-1));
+    double start_offset = init_traj(0, theta_idx) - base_heading.front();
+    double end_offset = std::remainder(sol[theta_idx] - base_heading.back(), 2 * M_PI);
+    sol[theta_idx] = base_heading.back() + end_offset;
+    for (int i = 0; i < n_steps; ++i)
+      base_heading[i] += start_offset + (end_offset - start_offset) * i / (n_steps - 1);
   }
-  std::reverse(base_pose.begin(),base_pose.end());
+
   for (int i = 0; i < n_steps; ++i)
   {
     if (i == 0)
       continue;
     
-    init_traj(i, 0) = interpolate(base_pose, nsteps_remap, i, true);
-    init_traj(i, 1) = interpolate(base_pose, nsteps_remap, i, false);
-    
-    if (std::isnan(init_traj(i, 0)) || std::isnan(init_traj(i, 1)))
-    {
-      init_traj(i, 0) = init_traj(i - 1, 0); 
-      init_traj(i, 1) = init_traj(i - 1, 1);
-    }
+    Eigen::Vector2d base_position = interpolatePosition(base_pose, nsteps_remap[i], options.smooth_base_path);
+    init_traj(i, 0) = base_position.x();
+    init_traj(i, 1) = base_position.y();
     
     for (int j = 2; j < inv_kin_mgr->getInvKinematicSolver(DEFAULT_VKC_GROUP_ID)->numJoints(); ++j)
     {
+      if (j == theta_idx)
+      {
+        init_traj(i, j) = base_heading[i];
+        continue;
+      }
       if ((sol[j] - init_traj(0 ,j)) > M_PI)
       {
         sol[j] -= 2 * M_PI;
@@ -392,8 +1451,7 @@ trajopt::TrajArray initTrajectory(VKCEnvBasic& env, std::vector<LinkDesiredPose>
       init_traj(i, 1) = base_pose.back().tf.translation()[1];
     }
   }
-  std::cout << "Initial trajectory:" << std::endl;
-  std::cout << init_traj << std::endl;
+  ROS_DEBUG_STREAM("Initial trajectory:" << std::endl << init_traj);
   return init_traj;
 }
 
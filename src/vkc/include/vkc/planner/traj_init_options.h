@@ -0,0 +1,103 @@
+#ifndef VKC_TRAJ_INIT_OPTIONS_H
+#define VKC_TRAJ_INIT_OPTIONS_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <nav_msgs/OccupancyGrid.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <vkc/planner/floor_geometry.h>
+#include <vkc/planner/traj_init_stats.h>
+
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+class BaseGridCache;
+class IKSolutionCache;
+class InverseReachabilityMap;
+
+/**
+ * @brief Settings of trajectory initialization, the same for all problems a ProbGenerator generates.
+ */
+struct TrajInitOptions
+{
+  /** @brief Workers building base grids from contact tests, 0 for one per hardware thread */
+  int grid_threads = 0;
+
+  /** @brief Search base paths on a coarse grid first and refine them in a corridor of the fine one */
+  bool coarse_to_fine = false;
+
+  /**
+   * @brief Search base paths on the roadmap of the environment first, which keeps its collision checks
+   * across problems; problems with swept shapes and paths it cannot find are searched on the grid
+   */
+  bool use_base_roadmap = false;
+
+  /**
+   * @brief Search base paths on the visibility graph of the environment first, which answers them with a few
+   * waypoints; scenes with obstacles other than boxes, problems with swept shapes and paths it cannot find are
+   * searched on the grid
+   */
+  bool use_visibility_graph = false;
+
+  /** @brief Seed the base along a spline through the planned path instead of its straight segments */
+  bool smooth_base_path = false;
+
+  /** @brief Seconds spent shortcutting each base path found on the grid, 0 to keep the grid path */
+  double shortcut_time = 0;
+
+  /** @brief Workers trying inverse kinematics seeds in parallel, 0 for one per hardware thread */
+  int ik_threads = 0;
+
+  /** @brief Directory in which the static layers of base grids are kept across runs, empty for none */
+  std::string grid_storage;
+
+  /**
+   * @brief File in which valid inverse kinematics solutions are kept across runs to seed later searches in the
+   * same scene, written when the generator is destroyed; empty to keep them for the lifetime of the generator only
+   */
+  std::string ik_cache_file;
+
+  /**
+   * @brief Inverse reachability map of the arm built offline, whose base placements seed inverse kinematics
+   * and the final base pose when it fails; empty to sample the base around the target instead
+   */
+  std::string reachability_map_file;
+};
+
+/**
+ * @brief State trajectory initialization reads and updates across calls, and inputs of a single call.
+ * All of it is optional, nullptr members are skipped.
+ */
+struct TrajInitContext
+{
+  /** @brief Receives the grid the base path was searched on, e.g. for publishing */
+  nav_msgs::OccupancyGrid* base_grid = nullptr;
+
+  /**
+   * @brief Floor grid from outside, e.g. a map server, searched before one is built from the scene.
+   * Lent to the search without copying and handed back unchanged; base_grid is not updated when it is used.
+   */
+  nav_msgs::OccupancyGrid* input_grid = nullptr;
+
+  /** @brief Grids of an unchanged scene are taken from and added to it */
+  BaseGridCache* grid_cache = nullptr;
+
+  /** @brief Solutions of nearby targets are tried first as seeds, valid solutions are added to it */
+  IKSolutionCache* ik_cache = nullptr;
+
+  /** @brief Ranks base placements from which the arm reaches a target */
+  const InverseReachabilityMap* reachability_map = nullptr;
+
+  /** @brief Floor the base has to keep clear of in addition to the scene, e.g. the sweep of a door */
+  const std::vector<FloorShape>* swept_shapes = nullptr;
+
+  /** @brief Receives the time spent in each stage and the rejections of inverse kinematics candidates */
+  TrajInitStats* stats = nullptr;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_TRAJ_INIT_OPTIONS_H
@@ -0,0 +1,101 @@
+#ifndef VKC_TRAJ_INIT_STATS_H
+#define VKC_TRAJ_INIT_STATS_H
+
+#include <chrono>
+
+namespace vkc
+{
+/**
+ * @brief Wall time initTrajectory() spends in each of its stages, and how its checks of inverse kinematics
+ * candidates rejected them, summed over the calls it is passed to.
+ */
+struct TrajInitStats
+{
+  enum Stage
+  {
+    CLONE = 0,  /**< @brief Cloning the contact manager, and the solvers of inverse kinematics workers */
+    GRID,       /**< @brief Floor distance field and base grids, including obstacles added to them */
+    SEARCH,     /**< @brief A* searches and shortcutting of the base path */
+    IK,         /**< @brief Inverse kinematics of the sampled seeds, summed over workers */
+    COLLISION,  /**< @brief Contact tests and floor lookups of sampled poses, summed over workers */
+    TOTAL,      /**< @brief Whole call */
+    STAGE_COUNT
+  };
+
+  /** @brief Checks of inverse kinematics candidates, cheapest first, a candidate stops at the first it fails. */
+  enum Check
+  {
+    JOINT_LIMITS = 0,     /**< @brief Joint values within their limits */
+    BASE_FOOTPRINT,       /**< @brief Base footprint clear of obstacles in the floor distance field */
+    SELF_COLLISION,       /**< @brief Robot and attached objects clear of each other */
+    ENVIRONMENT_CONTACT,  /**< @brief Robot clear of the whole scene */
+    CHECK_COUNT
+  };
+
+  double seconds[STAGE_COUNT];
+  int calls;
+  long candidates;               /**< @brief Inverse kinematics solutions checked */
+  long rejections[CHECK_COUNT];  /**< @brief Candidates rejected by each check */
+
+  TrajInitStats()
+  {
+    reset();
+  }
+
+  void reset()
+  {
+    for (int i = 0; i < STAGE_COUNT; ++i)
+      seconds[i] = 0;
+    calls = 0;
+    candidates = 0;
+    for (int i = 0; i < CHECK_COUNT; ++i)
+      rejections[i] = 0;
+  }
+
+  static const char* getStageName(int stage)
+  {
+    static const char* const names[STAGE_COUNT] = { "clone", "grid", "search", "ik", "collision", "total" };
+    return stage >= 0 && stage < STAGE_COUNT ? names[stage] : "unknown";
+  }
+
+  static const char* getCheckName(int check)
+  {
+    static const char* const names[CHECK_COUNT] = { "joint_limits", "base_footprint", "self_collision",
+                                                    "environment" };
+    return check >= 0 && check < CHECK_COUNT ? names[check] : "unknown";
+  }
+};
+
+/**
+ * @brief Adds the time from construction to stop() or destruction to a stage, does nothing without stats.
+ */
+class StageTimer
+{
+public:
+  StageTimer(TrajInitStats* stats, TrajInitStats::Stage stage)
+    : stats_(stats), stage_(stage), start_(std::chrono::steady_clock::now())
+  {
+  }
+
+  ~StageTimer()
+  {
+    stop();
+  }
+
+  void stop()
+  {
+    if (stats_ == nullptr)
+      return;
+    stats_->seconds[stage_] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    stats_ = nullptr;
+  }
+
+private:
+  TrajInitStats* stats_;
+  TrajInitStats::Stage stage_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_TRAJ_INIT_STATS_H
@@ -0,0 +1,107 @@
+#ifndef VKC_VISIBILITY_GRAPH_H
+#define VKC_VISIBILITY_GRAPH_H
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <Eigen/Eigen>
+#include <Eigen/StdVector>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract_environment/core/environment.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vkc
+{
+/**
+ * @brief Reduced visibility graph over the box obstacles of a scene, for planning base paths.
+ *
+ * Every collision box of the environment that reaches into the height band of the mobile base is
+ * projected onto the floor and inflated by the base radius. The graph connects the corners of these
+ * polygons that can see each other along a bitangent, which is enough to contain every shortest path.
+ * It is built once per scene and then answers shortest base paths between arbitrary points with a
+ * handful of waypoints, instead of rasterising and searching a floor grid.
+ */
+class VisibilityGraph
+{
+public:
+  using Ptr = std::shared_ptr<VisibilityGraph>;
+  using Polygon = std::vector<Eigen::Vector2d, Eigen::aligned_allocator<Eigen::Vector2d>>;
+
+  /**
+   * @param inflation Distance kept between the base center and any obstacle,
+   * 0 for the circumscribed radius of the base footprint
+   * @param max_height Top of the height band occupied by the base, boxes entirely above it are ignored,
+   * 0 for the top of the base collision geometry
+   */
+  VisibilityGraph(double inflation = 0, double max_height = 0);
+
+  /**
+   * @brief Extract the box obstacles of the environment and build the graph.
+   * Inflation and height band left at 0 are taken from the base footprint, see getBaseFootprint().
+   * Obstacles in the height band that are not boxes are left out, see isComplete().
+   * @param robot_links Links of the robot and anything attached to it, they are not obstacles
+   * @return Number of obstacles extracted
+   */
+  std::size_t build(const tesseract_environment::Environment& env, const std::vector<std::string>& robot_links);
+
+  /**
+   * @brief False if the last build() left out obstacles in the height band of the base that are not boxes,
+   * or could not derive the inflation; paths of the graph may then run through them.
+   */
+  bool isComplete() const;
+
+  /** @brief Add an obstacle given as a convex floor polygon, before inflation. */
+  void addObstacle(const Polygon& polygon);
+
+  /** @brief Drop all obstacles and graph edges. */
+  void clear();
+
+  /** @brief Connect the corners of the obstacles added so far. */
+  void buildGraph();
+
+  /**
+   * @brief Shortest collision free path between two floor positions.
+   * Obstacles that already contain start or goal are ignored for the first and last segment,
+   * the same way the grid planner never blocks its own start and goal cells.
+   * @param path Waypoints from start to goal, including both
+   * @return False if the goal cannot be reached
+   */
+  bool findPath(const Eigen::Vector2d& start, const Eigen::Vector2d& goal, Polygon& path) const;
+
+  const std::vector<Polygon>& getObstacles() const;
+
+private:
+  struct Corner
+  {
+    Eigen::Vector2d point;
+    std::size_t obstacle;
+    std::size_t index;
+  };
+
+  struct Edge
+  {
+    std::size_t to;
+    double cost;
+  };
+
+  bool isVisible(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const std::vector<std::size_t>& ignored) const;
+  bool isTangent(const Corner& corner, const Eigen::Vector2d& other) const;
+  std::vector<std::size_t> containingObstacles(const Eigen::Vector2d& point) const;
+
+  double requested_inflation_;
+  double requested_max_height_;
+  double inflation_;
+  double max_height_;
+  bool complete_;
+  std::vector<Polygon> obstacles_;
+  std::vector<Corner, Eigen::aligned_allocator<Corner>> corners_;
+  std::vector<bool> valid_corners_; /**< @brief False for corners swallowed by another obstacle */
+  std::vector<std::vector<Edge>> edges_;
+};
+
+}  // namespace vkc
+
+#endif  // VKC_VISIBILITY_GRAPH_H
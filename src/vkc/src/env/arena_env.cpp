@@ -37,6 +37,10 @@ ArenaEnv::ArenaEnv(ros::NodeHandle nh, bool plotting, bool rviz, int steps)
 
   createEnvironment();
 
+  initStaticBaseLayer();
+
+  initJointSweepRegions();
+
   ROS_INFO("Sucessfully create the environment, now creating optimization problem...");
 }
 
@@ -41,6 +41,10 @@ UrdfSceneEnv::UrdfSceneEnv(ros::NodeHandle nh, bool plotting, bool rviz, int ste
 
   createEnvironment();
 
+  initStaticBaseLayer();
+
+  initJointSweepRegions();
+
   ROS_INFO("Sucessfully create the environment, now creating optimization problem...");
 }
 
@@ -61,6 +61,7 @@ bool VKCEnvBasic::initTesseractConfig(const std::string& modify_env_srv, const s
   ROS_INFO("Initializing tesseract...");
 
   tesseract_->initTesseract();
+  registerBaseArmInvKin();
 
   ROS_INFO("Tesseract initialized...");
 
@@ -130,6 +131,128 @@ std::string VKCEnvBasic::getEndEffectorLink(){
   return end_effector_link_;
 }
 
+BaseRoadmap::Ptr VKCEnvBasic::getBaseRoadmap()
+{
+  if (base_roadmap_ == nullptr)
+    initBaseRoadmap();
+  else
+    base_roadmap_->update();
+  return base_roadmap_;
+}
+
+void VKCEnvBasic::initBaseRoadmap(double step_size)
+{
+  if (static_base_layer_ == nullptr)
+    return;
+
+  std::vector<std::string> robot_links =
+      tesseract_->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+  MapInfo map = fitMapInfo(*tesseract_->getTesseract()->getEnvironmentConst(), robot_links, step_size, step_size);
+
+  base_roadmap_ = std::make_shared<BaseRoadmap>(map);
+  base_roadmap_->build(tesseract_->getTesseract(), static_base_layer_->getDynamicLinks());
+}
+
+VisibilityGraph::Ptr VKCEnvBasic::getVisibilityGraph()
+{
+  if (static_base_layer_ == nullptr)
+    return nullptr;
+
+  tesseract_environment::Environment::ConstPtr environment = tesseract_->getTesseract()->getEnvironmentConst();
+  const std::vector<std::string>& dynamic_links = static_base_layer_->getDynamicLinks();
+  bool moved = visibility_graph_ == nullptr || visibility_graph_poses_.size() != dynamic_links.size();
+  for (std::size_t i = 0; !moved && i < dynamic_links.size(); ++i)
+    moved = !environment->getLinkTransform(dynamic_links[i]).isApprox(visibility_graph_poses_[i]);
+
+  if (moved)
+  {
+    std::vector<std::string> robot_links =
+        tesseract_->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+    visibility_graph_ = std::make_shared<VisibilityGraph>();
+    visibility_graph_->build(*environment, robot_links);
+
+    visibility_graph_poses_.clear();
+    for (const auto& link_name : dynamic_links)
+      visibility_graph_poses_.push_back(environment->getLinkTransform(link_name));
+  }
+  return visibility_graph_->isComplete() ? visibility_graph_ : nullptr;
+}
+
+StaticBaseLayer::Ptr VKCEnvBasic::getStaticBaseLayer()
+{
+  return static_base_layer_;
+}
+
+void VKCEnvBasic::initStaticBaseLayer()
+{
+  tesseract_environment::Environment::ConstPtr environment = tesseract_->getTesseract()->getEnvironmentConst();
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = environment->getSceneGraph();
+  std::vector<std::string> robot_links =
+      tesseract_->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+
+  // objects that are picked up move as a whole, fixed base objects only with their attach link
+  std::vector<std::string> dynamic_links;
+  for (auto& attach_location : attach_locations_)
+  {
+    std::string root = attach_location.second->link_name_;
+    if (!attach_location.second->fixed_base && !attach_location.second->base_link_.empty() &&
+        scene_graph->getLink(attach_location.second->base_link_) != nullptr)
+      root = attach_location.second->base_link_;
+
+    std::vector<std::string> subtree = scene_graph->getLinkChildrenNames(root);
+    dynamic_links.insert(dynamic_links.end(), subtree.begin(), subtree.end());
+    dynamic_links.push_back(root);
+  }
+
+  // articulated parts, e.g. doors and drawers, move with their joints
+  for (const auto& joint_name : getArticulatedJoints())
+  {
+    std::string child_link = scene_graph->getJoint(joint_name)->child_link_name;
+    std::vector<std::string> subtree = scene_graph->getLinkChildrenNames(child_link);
+    dynamic_links.insert(dynamic_links.end(), subtree.begin(), subtree.end());
+    dynamic_links.push_back(child_link);
+  }
+
+  static_base_layer_ = std::make_shared<StaticBaseLayer>(*environment, robot_links, dynamic_links);
+}
+
+JointSweepRegions::ConstPtr VKCEnvBasic::getJointSweepRegions()
+{
+  return joint_sweep_regions_;
+}
+
+void VKCEnvBasic::initJointSweepRegions()
+{
+  joint_sweep_regions_ = std::make_shared<JointSweepRegions>();
+  joint_sweep_regions_->build(*tesseract_->getTesseract()->getEnvironmentConst(), getArticulatedJoints());
+}
+
+std::vector<std::string> VKCEnvBasic::getArticulatedJoints()
+{
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph =
+      tesseract_->getTesseract()->getEnvironmentConst()->getSceneGraph();
+  std::vector<std::string> robot_links =
+      tesseract_->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+
+  std::vector<std::string> joint_names;
+  for (const auto& joint : scene_graph->getJoints())
+  {
+    if (joint->type != tesseract_scene_graph::JointType::FIXED &&
+        std::find(robot_links.begin(), robot_links.end(), joint->child_link_name) == robot_links.end())
+      joint_names.push_back(joint->getName());
+  }
+  return joint_names;
+}
+
+std::vector<std::string> VKCEnvBasic::getAttachedSubtree(std::string attach_location_name)
+{
+  std::string link_name = attach_locations_.at(attach_location_name)->link_name_;
+  std::vector<std::string> subtree =
+      tesseract_->getTesseract()->getEnvironment()->getSceneGraph()->getLinkChildrenNames(link_name);
+  subtree.push_back(link_name);
+  return subtree;
+}
+
 vkc::BaseObject::AttachLocation::Ptr VKCEnvBasic::getAttachLocation(std::string link_name)
 {
   auto attach_location = attach_locations_.find(link_name);
@@ -277,6 +400,12 @@ void VKCEnvBasic::attachObject(std::string attach_location_name, Eigen::Isometry
 
   end_effector_link_ = attach_locations_.at(attach_location_name)->base_link_;
   addAttachedLink(attach_location_name);
+
+  // the object joins or leaves the robot, whose links are not obstacles of the graph
+  visibility_graph_ = nullptr;
+
+  if (base_roadmap_ != nullptr)
+    base_roadmap_->updateLinks(getAttachedSubtree(attach_location_name), true);
 }
 
 void VKCEnvBasic::detachTopObject()
@@ -300,6 +429,12 @@ void VKCEnvBasic::detachTopObject()
   attach_locations_.at(target_location_name)->world_joint_origin_transform =
       tesseract_->getTesseract()->getEnvironment()->getLinkTransform(link_name) *
       attach_locations_.at(target_location_name)->local_joint_origin_transform;
+
+  // the object joins or leaves the robot, whose links are not obstacles of the graph
+  visibility_graph_ = nullptr;
+
+  if (base_roadmap_ != nullptr)
+    base_roadmap_->updateLinks(getAttachedSubtree(target_location_name), false);
 }
 
 void VKCEnvBasic::detachObject(std::string detach_location_name)
@@ -378,11 +513,53 @@ std::string VKCEnvBasic::updateEnv(std::vector<std::string>& joint_names,
     tesseract_->getTesseract()->clearKinematics();
     tesseract_->getTesseract()->registerDefaultFwdKinSolvers();
     tesseract_->getTesseract()->registerDefaultInvKinSolvers();
+    registerBaseArmInvKin();
   }
 
   return DEFAULT_VKC_GROUP_ID;
 }
 
+void VKCEnvBasic::registerBaseArmInvKin()
+{
+  tesseract::Tesseract::Ptr tesseract = tesseract_->getTesseract();
+  tesseract_kinematics::ForwardKinematics::ConstPtr fwd_kin =
+      tesseract->getFwdKinematicsManagerConst()->getFwdKinematicSolver(DEFAULT_VKC_GROUP_ID);
+  if (fwd_kin == nullptr)
+    return;
+
+  // walk up from the robot end effector, past fixed joints, to the six joints of the arm
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = tesseract->getEnvironmentConst()->getSceneGraph();
+  std::vector<std::string> arm_joints;
+  std::string arm_base_link;
+  std::string arm_tip_link;
+  std::string link_name = robot_end_effector_link_;
+  while (arm_joints.size() < 6)
+  {
+    std::vector<tesseract_scene_graph::Joint::ConstPtr> joints = scene_graph->getInboundJoints(link_name);
+    if (joints.empty())
+      break;
+    if (joints[0]->type != JointType::FIXED)
+    {
+      if (arm_joints.empty())
+        arm_tip_link = joints[0]->child_link_name;
+      arm_joints.insert(arm_joints.begin(), joints[0]->getName());
+      arm_base_link = joints[0]->parent_link_name;
+    }
+    link_name = joints[0]->parent_link_name;
+  }
+
+  PlanarBaseURInvKin::Ptr inv_kin = PlanarBaseURInvKin::create();
+  if (!inv_kin->init(fwd_kin, DEFAULT_VKC_GROUP_ID, { "base_y_base_x", "base_theta_base_y", "base_link_base_theta" },
+                     arm_joints, arm_base_link, arm_tip_link))
+  {
+    ROS_DEBUG("The arm has no closed form inverse kinematics, keeping the numerical solver.");
+    return;
+  }
+
+  tesseract->getInvKinematicsManager()->addInvKinematicSolver(inv_kin);
+  tesseract->getInvKinematicsManager()->setDefaultInvKinematicSolver(DEFAULT_VKC_GROUP_ID, inv_kin->getSolverName());
+}
+
 bool VKCEnvBasic::isGroupExist(std::string group_id)
 {
   bool isfound_group = false;
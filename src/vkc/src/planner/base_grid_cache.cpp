@@ -0,0 +1,113 @@
+#include <vkc/planner/base_grid_cache.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace vkc
+{
+namespace
+{
+void hashCombine(std::size_t& seed, double value)
+{
+  seed ^= std::hash<double>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+}  // namespace
+
+bool BaseGridCache::Key::operator==(const Key& other) const
+{
+  return map == other.map && revision == other.revision && scene_hash == other.scene_hash;
+}
+
+BaseGridCache::BaseGridCache(std::size_t capacity) : capacity_(capacity), hits_(0), misses_(0)
+{
+}
+
+BaseGridCache::Key BaseGridCache::makeKey(VKCEnvBasic& env, const MapInfo& map)
+{
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  std::vector<std::string> robot_links =
+      env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+
+  // poses of everything that is an obstacle to the base, e.g. opened doors, in scene graph order
+  std::size_t scene_hash = 0;
+  for (const auto& link : environment->getSceneGraph()->getLinks())
+  {
+    if (link->collision.empty() ||
+        std::find(robot_links.begin(), robot_links.end(), link->getName()) != robot_links.end())
+      continue;
+
+    const Eigen::Isometry3d& tf = environment->getLinkTransform(link->getName());
+    for (Eigen::Index i = 0; i < tf.matrix().size(); ++i)
+      hashCombine(scene_hash, tf.matrix().data()[i]);
+  }
+
+  return Key{ map, static_cast<long>(environment->getRevision()), scene_hash };
+}
+
+bool BaseGridCache::lookup(const Key& key, AStar::Generator& astar_generator)
+{
+  auto entry = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) { return e.key == key; });
+  if (entry == entries_.end())
+  {
+    ++misses_;
+    return false;
+  }
+
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, entry);
+
+  // the search changes its grid, hand out a copy
+  AStar::CollisionMap cells = entry->cells;
+  astar_generator.setWorldSize({ key.map.grid_size_x, key.map.grid_size_y });
+  astar_generator.swapCollisionMap(cells);
+  return true;
+}
+
+bool BaseGridCache::rasterise(VKCEnvBasic& env, const MapInfo& map, AStar::Generator& astar_generator)
+{
+  auto grid = std::find_if(grids_.begin(), grids_.end(),
+                           [&](const IncrementalBaseGrid& g) { return g.getMapInfo() == map; });
+  if (grid == grids_.end())
+  {
+    // layouts follow the scene bounds, drop the oldest beyond the capacity of the cache
+    if (grids_.size() >= std::max<std::size_t>(capacity_, 1))
+      grids_.erase(grids_.begin());
+    grid = grids_.insert(grids_.end(), IncrementalBaseGrid(map));
+  }
+
+  if (!grid->update(env))
+    return false;
+
+  ROS_DEBUG("Base grid updated, %lu links rasterised", grid->getUpdatedLinkCount());
+  grid->exportTo(astar_generator);
+  return true;
+}
+
+void BaseGridCache::store(const Key& key, const AStar::Generator& astar_generator)
+{
+  if (capacity_ == 0)
+    return;
+
+  entries_.remove_if([&](const Entry& e) { return e.key == key; });
+  entries_.push_front(Entry{ key, astar_generator.getCollisionMap() });
+  while (entries_.size() > capacity_)
+    entries_.pop_back();
+}
+
+void BaseGridCache::clear()
+{
+  entries_.clear();
+  grids_.clear();
+}
+
+std::size_t BaseGridCache::getHits() const
+{
+  return hits_;
+}
+
+std::size_t BaseGridCache::getMisses() const
+{
+  return misses_;
+}
+
+}  // namespace vkc
@@ -0,0 +1,367 @@
+#include <vkc/planner/base_roadmap.h>
+#include <vkc/planner/floor_geometry.h>
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <ros/console.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace vkc
+{
+namespace
+{
+// lattice directions, ordered so that the opposite of dir is (dir + 4) % 8
+const int DIR_X[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+const int DIR_Y[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+// pseudo directions of the search, for the straight connections of the query points
+const std::size_t FROM_START = 8;
+const std::size_t TO_GOAL = 9;
+
+// height of the base link while driving, see buildBaseGrid()
+const double BASE_HEIGHT = 0.13;
+
+struct QueueEntry
+{
+  double f;
+  double g;
+  std::size_t node;
+  std::size_t parent;
+  std::size_t dir;
+
+  bool operator>(const QueueEntry& other) const
+  {
+    return f > other.f;
+  }
+};
+}  // namespace
+
+BaseRoadmap::BaseRoadmap(const MapInfo& map, double check_resolution)
+  : map_(map), check_resolution_(check_resolution), base_link_name_("base_link"), check_count_(0)
+{
+}
+
+void BaseRoadmap::build(tesseract::Tesseract::ConstPtr tesseract, const std::vector<std::string>& movable_links)
+{
+  env_ = tesseract->getEnvironmentConst();
+  contact_manager_ = env_->getDiscreteContactManager()->clone();
+
+  // the robot only takes part with its base, the arm and anything it carries are not relevant here,
+  // carried objects are only disabled as updateLinks() brings them back once they are detached
+  std::vector<std::string> robot_links =
+      tesseract->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+  for (auto& link_name : robot_links)
+  {
+    if (link_name == base_link_name_ || link_name == "world")
+      continue;
+    if (std::find(movable_links.begin(), movable_links.end(), link_name) != movable_links.end())
+      contact_manager_->disableCollisionObject(link_name);
+    else
+      contact_manager_->removeCollisionObject(link_name);
+  }
+  contact_manager_->setActiveCollisionObjects({ base_link_name_ });
+
+  // use a footprint that covers every heading of the base
+  Eigen::AlignedBox2d base_bounds;
+  footprint_.setEmpty();
+  if (getLinkFloorBounds(*env_, base_link_name_, base_bounds))
+  {
+    Eigen::Vector2d base_position = env_->getLinkTransform(base_link_name_).translation().head<2>();
+    double radius = std::max((base_bounds.min() - base_position).norm(), (base_bounds.max() - base_position).norm());
+    footprint_.extend(Eigen::Vector2d::Constant(-radius));
+    footprint_.extend(Eigen::Vector2d::Constant(radius));
+  }
+  else
+  {
+    ROS_WARN("Base link has no collision geometry, the roadmap only invalidates edges crossing moved links.");
+    footprint_.extend(Eigen::Vector2d::Zero());
+  }
+
+  movable_bounds_.clear();
+  for (auto& link_name : movable_links)
+  {
+    Eigen::AlignedBox2d bounds;
+    if (std::find(robot_links.begin(), robot_links.end(), link_name) == robot_links.end() &&
+        getLinkFloorBounds(*env_, link_name, bounds))
+      movable_bounds_[link_name] = bounds;
+  }
+
+  std::size_t n_nodes = static_cast<std::size_t>(map_.grid_size_x) * static_cast<std::size_t>(map_.grid_size_y);
+  nodes_.assign(n_nodes, Validity::UNKNOWN);
+  edges_.assign(8 * n_nodes, Validity::UNKNOWN);
+  check_count_ = 0;
+}
+
+void BaseRoadmap::updateLinks(const std::vector<std::string>& link_names, bool attached)
+{
+  if (contact_manager_ == nullptr)
+    return;
+
+  for (auto& link_name : link_names)
+  {
+    auto previous = movable_bounds_.find(link_name);
+    if (previous != movable_bounds_.end())
+    {
+      invalidate(previous->second);
+      movable_bounds_.erase(previous);
+    }
+
+    if (attached)
+    {
+      contact_manager_->disableCollisionObject(link_name);
+      continue;
+    }
+
+    contact_manager_->enableCollisionObject(link_name);
+    contact_manager_->setCollisionObjectsTransform(link_name, env_->getLinkTransform(link_name));
+
+    Eigen::AlignedBox2d bounds;
+    if (getLinkFloorBounds(*env_, link_name, bounds))
+    {
+      invalidate(bounds);
+      movable_bounds_[link_name] = bounds;
+    }
+  }
+}
+
+void BaseRoadmap::update()
+{
+  if (contact_manager_ == nullptr)
+    return;
+
+  for (auto& movable : movable_bounds_)
+  {
+    contact_manager_->setCollisionObjectsTransform(movable.first, env_->getLinkTransform(movable.first));
+
+    Eigen::AlignedBox2d bounds;
+    if (!getLinkFloorBounds(*env_, movable.first, bounds) || bounds.isApprox(movable.second))
+      continue;
+
+    invalidate(movable.second);
+    invalidate(bounds);
+    movable.second = bounds;
+  }
+}
+
+bool BaseRoadmap::findPath(const Eigen::Vector2d& start, const Eigen::Vector2d& goal, Path& path)
+{
+  path.clear();
+  if (contact_manager_ == nullptr)
+  {
+    ROS_WARN("Base roadmap queried before it was built.");
+    return false;
+  }
+
+  const std::size_t n_nodes = nodes_.size();
+  const std::size_t start_node = n_nodes;
+  const std::size_t goal_node = n_nodes + 1;
+  const double connection_radius = 1.5 * map_.step_size;
+
+  auto position = [&](std::size_t node) -> Eigen::Vector2d {
+    if (node == start_node)
+      return start;
+    if (node == goal_node)
+      return goal;
+    return nodePosition(node);
+  };
+
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+  std::vector<std::size_t> parent(n_nodes + 2, n_nodes + 2);
+  std::vector<bool> closed(n_nodes + 2, false);
+
+  auto push = [&](std::size_t from, std::size_t to, std::size_t dir, double g_from) {
+    double g = g_from + (position(to) - position(from)).norm();
+    open.push({ g + (goal - position(to)).norm(), g, to, from, dir });
+  };
+
+  // queue every lattice node around a query point, edges are only checked once they are popped
+  auto forEachNodeNear = [&](const Eigen::Vector2d& point, const std::function<void(std::size_t)>& visit) {
+    int x_min = std::max(0, map_.toGridX(point.x() - connection_radius));
+    int x_max = std::min(map_.grid_size_x - 1, map_.toGridX(point.x() + connection_radius));
+    int y_min = std::max(0, map_.toGridY(point.y() - connection_radius));
+    int y_max = std::min(map_.grid_size_y - 1, map_.toGridY(point.y() + connection_radius));
+    for (int x = x_min; x <= x_max; ++x)
+    {
+      for (int y = y_min; y <= y_max; ++y)
+      {
+        std::size_t node = nodeIndex(x, y);
+        if ((nodePosition(node) - point).norm() <= connection_radius)
+          visit(node);
+      }
+    }
+  };
+
+  closed[start_node] = true;
+  forEachNodeNear(start, [&](std::size_t node) { push(start_node, node, FROM_START, 0.0); });
+  if ((goal - start).norm() <= connection_radius)
+    push(start_node, goal_node, TO_GOAL, 0.0);
+
+  while (!open.empty())
+  {
+    QueueEntry entry = open.top();
+    open.pop();
+    if (closed[entry.node])
+      continue;
+
+    // lazy evaluation of the edge the entry was reached through
+    bool valid;
+    if (entry.dir == TO_GOAL)
+      valid = isSegmentFree(position(entry.parent), goal);
+    else if (entry.dir == FROM_START)
+      valid = isNodeValid(entry.node) && isSegmentFree(start, nodePosition(entry.node));
+    else
+      valid = isNodeValid(entry.node) && isEdgeValid(entry.parent, entry.dir);
+    if (!valid)
+      continue;
+
+    closed[entry.node] = true;
+    parent[entry.node] = entry.parent;
+
+    if (entry.node == goal_node)
+    {
+      for (std::size_t node = goal_node; node != start_node; node = parent[node])
+        path.push_back(position(node));
+      path.push_back(start);
+      std::reverse(path.begin(), path.end());
+      return true;
+    }
+
+    for (std::size_t dir = 0; dir < 8; ++dir)
+    {
+      std::size_t other;
+      if (neighbour(entry.node, dir, other) && !closed[other] && edges_[8 * entry.node + dir] != Validity::INVALID)
+        push(entry.node, other, dir, entry.g);
+    }
+    if ((goal - nodePosition(entry.node)).norm() <= connection_radius)
+      push(entry.node, goal_node, TO_GOAL, entry.g);
+  }
+
+  return false;
+}
+
+const MapInfo& BaseRoadmap::getMapInfo() const
+{
+  return map_;
+}
+
+std::size_t BaseRoadmap::getCheckCount() const
+{
+  return check_count_;
+}
+
+std::size_t BaseRoadmap::nodeIndex(int x, int y) const
+{
+  return static_cast<std::size_t>(y) * static_cast<std::size_t>(map_.grid_size_x) + static_cast<std::size_t>(x);
+}
+
+Eigen::Vector2d BaseRoadmap::nodePosition(std::size_t node) const
+{
+  std::size_t width = static_cast<std::size_t>(map_.grid_size_x);
+  return Eigen::Vector2d(map_.toWorldX(static_cast<int>(node % width)), map_.toWorldY(static_cast<int>(node / width)));
+}
+
+bool BaseRoadmap::neighbour(std::size_t node, std::size_t dir, std::size_t& other) const
+{
+  std::size_t width = static_cast<std::size_t>(map_.grid_size_x);
+  int x = static_cast<int>(node % width) + DIR_X[dir];
+  int y = static_cast<int>(node / width) + DIR_Y[dir];
+  if (x < 0 || y < 0 || x >= map_.grid_size_x || y >= map_.grid_size_y)
+    return false;
+
+  other = nodeIndex(x, y);
+  return true;
+}
+
+bool BaseRoadmap::isNodeValid(std::size_t node)
+{
+  if (nodes_[node] == Validity::UNKNOWN)
+    nodes_[node] = isFree(nodePosition(node)) ? Validity::VALID : Validity::INVALID;
+
+  return nodes_[node] == Validity::VALID;
+}
+
+bool BaseRoadmap::isEdgeValid(std::size_t node, std::size_t dir)
+{
+  std::size_t other;
+  if (!neighbour(node, dir, other))
+    return false;
+
+  Validity& state = edges_[8 * node + dir];
+  if (state == Validity::UNKNOWN)
+  {
+    state = isSegmentFree(nodePosition(node), nodePosition(other)) ? Validity::VALID : Validity::INVALID;
+    edges_[8 * other + (dir + 4) % 8] = state;
+  }
+
+  return state == Validity::VALID;
+}
+
+bool BaseRoadmap::isFree(const Eigen::Vector2d& position)
+{
+  ++check_count_;
+
+  Eigen::Isometry3d base_tf;
+  base_tf.setIdentity();
+  base_tf.translation() = Eigen::Vector3d(position.x(), position.y(), BASE_HEIGHT);
+
+  tesseract_collision::ContactResultMap contact_results;
+  contact_manager_->setCollisionObjectsTransform(base_link_name_, base_tf);
+  contact_manager_->contactTest(contact_results, tesseract_collision::ContactTestType::FIRST);
+  return contact_results.empty();
+}
+
+bool BaseRoadmap::isSegmentFree(const Eigen::Vector2d& from, const Eigen::Vector2d& to)
+{
+  // end points are covered by the node checks or belong to the query
+  int n_steps = std::max(1, static_cast<int>(std::ceil((to - from).norm() / check_resolution_)));
+  for (int i = 1; i < n_steps; ++i)
+  {
+    if (!isFree(from + (to - from) * (double(i) / n_steps)))
+      return false;
+  }
+  return true;
+}
+
+void BaseRoadmap::invalidate(const Eigen::AlignedBox2d& bounds)
+{
+  // any node whose footprint, or edge whose swept footprint, may overlap bounds
+  Eigen::AlignedBox2d reach(bounds.min() + footprint_.min(), bounds.max() + footprint_.max());
+
+  int x_min = std::max(0, map_.toGridX(reach.min().x()) - 1);
+  int x_max = std::min(map_.grid_size_x - 1, map_.toGridX(reach.max().x()) + 1);
+  int y_min = std::max(0, map_.toGridY(reach.min().y()) - 1);
+  int y_max = std::min(map_.grid_size_y - 1, map_.toGridY(reach.max().y()) + 1);
+
+  for (int x = x_min; x <= x_max; ++x)
+  {
+    for (int y = y_min; y <= y_max; ++y)
+    {
+      std::size_t node = nodeIndex(x, y);
+      Eigen::Vector2d position = nodePosition(node);
+      if (reach.contains(position))
+        nodes_[node] = Validity::UNKNOWN;
+
+      for (std::size_t dir = 0; dir < 8; ++dir)
+      {
+        std::size_t other;
+        if (!neighbour(node, dir, other))
+          continue;
+
+        Eigen::AlignedBox2d swept(position);
+        swept.extend(nodePosition(other));
+        if (swept.intersects(reach))
+        {
+          edges_[8 * node + dir] = Validity::UNKNOWN;
+          edges_[8 * other + (dir + 4) % 8] = Validity::UNKNOWN;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace vkc
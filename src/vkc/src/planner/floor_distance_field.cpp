@@ -0,0 +1,205 @@
+#include <vkc/planner/floor_distance_field.h>
+#include <vkc/planner/occupancy_builder.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vkc
+{
+namespace
+{
+// squared distance of cells without obstacle in reach, large but finite so that it can be subtracted
+const double FAR = 1e20;
+}  // namespace
+
+FloorDistanceField::FloorDistanceField() : map_(0, 0, 1.0), inscribed_radius_(0), circumscribed_radius_(0)
+{
+}
+
+bool FloorDistanceField::build(VKCEnvBasic& env, const MapInfo& map)
+{
+  std::string base_link_name = "base_link";
+  distance_.clear();
+
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = environment->getSceneGraph();
+  std::vector<std::string> robot_links =
+      env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+
+  FloorShape footprint;
+  if (!getBaseFootprint(*environment, base_link_name, footprint))
+    return false;
+
+  // the base is assumed to contain its own position, otherwise no circle fits around it
+  inscribed_radius_ = std::numeric_limits<double>::max();
+  circumscribed_radius_ = 0;
+  std::size_t n = footprint.hull.size();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const Eigen::Vector2d& a = footprint.hull[i];
+    const Eigen::Vector2d& b = footprint.hull[(i + 1) % n];
+    Eigen::Vector2d edge = b - a;
+    double cross = edge.x() * a.y() - edge.y() * a.x();
+    inscribed_radius_ = std::min(inscribed_radius_, std::max(0.0, -cross / edge.norm()));
+    circumscribed_radius_ = std::max(circumscribed_radius_, a.norm());
+  }
+
+  // a cell is blocked if the shape covers any part of it, rasterised like the base grid with a cell sized base
+  FloorShape cell;
+  double half_step = map.step_size / 2.0;
+  cell.hull = { Eigen::Vector2d(-half_step, -half_step), Eigen::Vector2d(half_step, -half_step),
+                Eigen::Vector2d(half_step, half_step), Eigen::Vector2d(-half_step, half_step) };
+  cell.z_min = footprint.z_min;
+  cell.z_max = footprint.z_max;
+
+  std::vector<std::size_t> blocked;
+  for (const auto& link : scene_graph->getLinks())
+  {
+    if (std::find(robot_links.begin(), robot_links.end(), link->getName()) != robot_links.end() ||
+        !scene_graph->getLinkCollisionEnabled(link->getName()))
+      continue;
+
+    std::vector<FloorShape> shapes;
+    if (!getLinkFloorShapes(*link, environment->getLinkTransform(link->getName()), shapes))
+      return false;
+
+    for (const auto& shape : shapes)
+      rasteriseShape(shape, cell, map, blocked);
+  }
+
+  AStar::CollisionMap cells(static_cast<std::size_t>(map.grid_size_x) * static_cast<std::size_t>(map.grid_size_y), 0);
+  for (auto index : blocked)
+    cells[index] = 100;
+  compute(cells, map);
+  return true;
+}
+
+void FloorDistanceField::compute(const AStar::CollisionMap& cells, const MapInfo& map)
+{
+  map_ = map;
+  int width = map.grid_size_x;
+  int height = map.grid_size_y;
+  int longest = std::max(width, height);
+
+  std::vector<double> squared(cells.size());
+  std::transform(cells.begin(), cells.end(), squared.begin(), [](std::int8_t cell) { return cell != 0 ? 0 : FAR; });
+
+  // the squared euclidean distance separates into a pass over the columns and one over the rows
+  std::vector<double> f(static_cast<std::size_t>(longest)), d(static_cast<std::size_t>(longest));
+  std::vector<double> z(static_cast<std::size_t>(longest) + 1);
+  std::vector<int> v(static_cast<std::size_t>(longest));
+  for (int x = 0; x < width; ++x)
+  {
+    for (int y = 0; y < height; ++y)
+      f[static_cast<std::size_t>(y)] = squared[static_cast<std::size_t>(y * width + x)];
+    transform(f, height, d, v, z);
+    for (int y = 0; y < height; ++y)
+      squared[static_cast<std::size_t>(y * width + x)] = d[static_cast<std::size_t>(y)];
+  }
+
+  distance_.resize(cells.size());
+  for (int y = 0; y < height; ++y)
+  {
+    std::copy_n(squared.begin() + y * width, width, f.begin());
+    transform(f, width, d, v, z);
+    for (int x = 0; x < width; ++x)
+      distance_[static_cast<std::size_t>(y * width + x)] =
+          static_cast<float>(std::sqrt(d[static_cast<std::size_t>(x)]) * map.step_size);
+  }
+}
+
+bool FloorDistanceField::empty() const
+{
+  return distance_.empty();
+}
+
+const MapInfo& FloorDistanceField::getMapInfo() const
+{
+  return map_;
+}
+
+double FloorDistanceField::getDistance(int x, int y) const
+{
+  if (x < 0 || x >= map_.grid_size_x || y < 0 || y >= map_.grid_size_y || distance_.empty())
+    return 0;
+  return distance_[static_cast<std::size_t>(y) * static_cast<std::size_t>(map_.grid_size_x) + static_cast<std::size_t>(x)];
+}
+
+double FloorDistanceField::getDistance(const Eigen::Vector2d& point) const
+{
+  return getDistance(map_.toGridX(point.x()), map_.toGridY(point.y()));
+}
+
+double FloorDistanceField::getErrorBound() const
+{
+  // half a cell diagonal between the point and its cell center, and as much between an obstacle and
+  // the center of the cell it blocks
+  return std::sqrt(2.0) * map_.step_size;
+}
+
+double FloorDistanceField::getBaseInscribedRadius() const
+{
+  return inscribed_radius_;
+}
+
+double FloorDistanceField::getBaseCircumscribedRadius() const
+{
+  return circumscribed_radius_;
+}
+
+bool FloorDistanceField::isBaseInCollision(const Eigen::Vector2d& point) const
+{
+  if (distance_.empty())
+    return false;
+  return getDistance(point) + getErrorBound() < inscribed_radius_;
+}
+
+void FloorDistanceField::getClearanceCosts(double min_distance, double max_distance, AStar::uint weight,
+                                           AStar::CostMap& costs) const
+{
+  costs.resize(distance_.size());
+  double range = std::max(max_distance - min_distance, 1e-9);
+  std::transform(distance_.begin(), distance_.end(), costs.begin(), [&](float distance) {
+    double t = std::min(1.0, std::max(0.0, (max_distance - distance) / range));
+    return static_cast<AStar::uint>(std::lround(weight * t));
+  });
+}
+
+void FloorDistanceField::transform(const std::vector<double>& f, int n, std::vector<double>& d, std::vector<int>& v,
+                                   std::vector<double>& z)
+{
+  // lower envelope of the parabolas rooted at every cell, v holds their cells and z their boundaries
+  auto intersect = [&](int q, int p) {
+    return ((f[static_cast<std::size_t>(q)] + q * q) - (f[static_cast<std::size_t>(p)] + p * p)) / (2.0 * (q - p));
+  };
+
+  int k = 0;
+  v[0] = 0;
+  z[0] = -FAR;
+  z[1] = FAR;
+  for (int q = 1; q < n; ++q)
+  {
+    double s = intersect(q, v[static_cast<std::size_t>(k)]);
+    while (k > 0 && s <= z[static_cast<std::size_t>(k)])
+    {
+      --k;
+      s = intersect(q, v[static_cast<std::size_t>(k)]);
+    }
+    ++k;
+    v[static_cast<std::size_t>(k)] = q;
+    z[static_cast<std::size_t>(k)] = s;
+    z[static_cast<std::size_t>(k) + 1] = FAR;
+  }
+
+  k = 0;
+  for (int q = 0; q < n; ++q)
+  {
+    while (z[static_cast<std::size_t>(k) + 1] < q)
+      ++k;
+    int p = v[static_cast<std::size_t>(k)];
+    d[static_cast<std::size_t>(q)] = (q - p) * (q - p) + f[static_cast<std::size_t>(p)];
+  }
+}
+
+}  // namespace vkc
@@ -0,0 +1,425 @@
+#include <vkc/planner/floor_geometry.h>
+
+#include <tesseract_geometry/geometries.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace vkc
+{
+namespace
+{
+const double EPSILON = 1e-9;
+
+// tolerance of cell centers on the boundary of a rasterised shape
+const double RASTER_EPSILON = 1e-6;
+
+// number of sides of the polygons standing in for circles
+const int CIRCLE_SIDES = 16;
+
+// height of the base link while driving, see buildBaseGrid()
+const double BASE_HEIGHT = 0.13;
+
+using Points = std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>>;
+
+double cross(const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+{
+  return a.x() * b.y() - a.y() * b.x();
+}
+
+// Corners of an axis aligned box given in the collision frame
+void addBox(const Eigen::Isometry3d& tf, const Eigen::Vector3d& half_extents, Points& points)
+{
+  for (int corner = 0; corner < 8; ++corner)
+  {
+    points.push_back(tf * Eigen::Vector3d(((corner & 1) ? 1 : -1) * half_extents.x(),
+                                          ((corner & 2) ? 1 : -1) * half_extents.y(),
+                                          ((corner & 4) ? 1 : -1) * half_extents.z()));
+  }
+}
+
+// Distance between two convex polygons, 0 if they overlap or touch
+double polygonDistance(const FloorPolygon& a, const FloorPolygon& b)
+{
+  auto pointToSegment = [](const Eigen::Vector2d& p, const Eigen::Vector2d& s0, const Eigen::Vector2d& s1) {
+    Eigen::Vector2d d = s1 - s0;
+    double t = d.squaredNorm() > EPSILON ? std::min(1.0, std::max(0.0, (p - s0).dot(d) / d.squaredNorm())) : 0.0;
+    return (s0 + t * d - p).norm();
+  };
+
+  // separating axis test on the edge normals of both polygons
+  auto separated = [](const FloorPolygon& p, const FloorPolygon& q) {
+    std::size_t n = p.size();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      Eigen::Vector2d edge = p[(i + 1) % n] - p[i];
+      Eigen::Vector2d axis(edge.y(), -edge.x());
+      double p_max = -std::numeric_limits<double>::max();
+      double q_min = std::numeric_limits<double>::max();
+      for (const auto& point : p)
+        p_max = std::max(p_max, axis.dot(point));
+      for (const auto& point : q)
+        q_min = std::min(q_min, axis.dot(point));
+      if (q_min > p_max)
+        return true;
+    }
+    return false;
+  };
+  if (!separated(a, b) && !separated(b, a))
+    return 0;
+
+  double distance = std::numeric_limits<double>::max();
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    for (std::size_t j = 0; j < b.size(); ++j)
+    {
+      distance = std::min(distance, pointToSegment(a[i], b[j], b[(j + 1) % b.size()]));
+      distance = std::min(distance, pointToSegment(b[j], a[i], a[(i + 1) % a.size()]));
+    }
+  }
+  return distance;
+}
+
+// Circumscribed polygons of the two caps of a z aligned cylinder given in the collision frame
+void addCylinder(const Eigen::Isometry3d& tf, double radius, double half_length, Points& points)
+{
+  double outer_radius = radius / std::cos(M_PI / CIRCLE_SIDES);
+  for (int i = 0; i < CIRCLE_SIDES; ++i)
+  {
+    double angle = 2.0 * M_PI * i / CIRCLE_SIDES;
+    Eigen::Vector3d rim(outer_radius * std::cos(angle), outer_radius * std::sin(angle), 0);
+    points.push_back(tf * (rim + Eigen::Vector3d(0, 0, half_length)));
+    points.push_back(tf * (rim - Eigen::Vector3d(0, 0, half_length)));
+  }
+}
+}  // namespace
+
+FloorPolygon convexHull(FloorPolygon points)
+{
+  if (points.size() < 3)
+    return points;
+
+  std::sort(points.begin(), points.end(), [](const Eigen::Vector2d& a, const Eigen::Vector2d& b) {
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+  });
+
+  FloorPolygon hull(2 * points.size());
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    while (k >= 2 && cross(hull[k - 1] - hull[k - 2], points[i] - hull[k - 2]) <= EPSILON)
+      --k;
+    hull[k++] = points[i];
+  }
+  for (std::size_t i = points.size() - 1, t = k + 1; i > 0; --i)
+  {
+    while (k >= t && cross(hull[k - 1] - hull[k - 2], points[i - 1] - hull[k - 2]) <= EPSILON)
+      --k;
+    hull[k++] = points[i - 1];
+  }
+  hull.resize(k > 1 ? k - 1 : k);
+  return hull;
+}
+
+bool getLinkFloorShapes(const tesseract_scene_graph::Link& link, const Eigen::Isometry3d& link_tf,
+                        std::vector<FloorShape>& shapes)
+{
+  bool supported = true;
+  for (const auto& collision : link.collision)
+  {
+    Eigen::Isometry3d tf = link_tf * collision->origin;
+    Points points;
+    switch (collision->geometry->getType())
+    {
+      case tesseract_geometry::GeometryType::BOX:
+      {
+        auto box = std::static_pointer_cast<const tesseract_geometry::Box>(collision->geometry);
+        addBox(tf, 0.5 * Eigen::Vector3d(box->getX(), box->getY(), box->getZ()), points);
+        break;
+      }
+      case tesseract_geometry::GeometryType::SPHERE:
+      {
+        auto sphere = std::static_pointer_cast<const tesseract_geometry::Sphere>(collision->geometry);
+        addCylinder(tf, sphere->getRadius(), sphere->getRadius(), points);
+        break;
+      }
+      case tesseract_geometry::GeometryType::CYLINDER:
+      {
+        auto cylinder = std::static_pointer_cast<const tesseract_geometry::Cylinder>(collision->geometry);
+        addCylinder(tf, cylinder->getRadius(), cylinder->getLength() / 2.0, points);
+        break;
+      }
+      case tesseract_geometry::GeometryType::CONE:
+      {
+        auto cone = std::static_pointer_cast<const tesseract_geometry::Cone>(collision->geometry);
+        addCylinder(tf, cone->getRadius(), cone->getLength() / 2.0, points);
+        break;
+      }
+      case tesseract_geometry::GeometryType::MESH:
+      case tesseract_geometry::GeometryType::CONVEX_MESH:
+      case tesseract_geometry::GeometryType::SDF_MESH:
+      {
+        auto mesh = std::static_pointer_cast<const tesseract_geometry::PolygonMesh>(collision->geometry);
+        for (const auto& vertex : *(mesh->getVertices()))
+          points.push_back(tf * vertex);
+        break;
+      }
+      default:
+        // planes and octrees have no bounded convex outline
+        supported = false;
+        break;
+    }
+
+    if (points.empty())
+      continue;
+
+    FloorShape shape;
+    shape.z_min = std::numeric_limits<double>::max();
+    shape.z_max = -std::numeric_limits<double>::max();
+    FloorPolygon outline;
+    outline.reserve(points.size());
+    for (const auto& point : points)
+    {
+      outline.push_back(point.head<2>());
+      shape.z_min = std::min(shape.z_min, point.z());
+      shape.z_max = std::max(shape.z_max, point.z());
+    }
+    shape.hull = convexHull(outline);
+    shapes.push_back(shape);
+  }
+
+  return supported;
+}
+
+bool getLinkFloorBounds(const tesseract_environment::Environment& env, const std::string& link_name,
+                        Eigen::AlignedBox2d& bounds)
+{
+  bounds.setEmpty();
+
+  tesseract_scene_graph::Link::ConstPtr link = env.getSceneGraph()->getLink(link_name);
+  if (link == nullptr)
+    return false;
+
+  std::vector<FloorShape> shapes;
+  getLinkFloorShapes(*link, env.getLinkTransform(link_name), shapes);
+  for (const auto& shape : shapes)
+  {
+    for (const auto& point : shape.hull)
+      bounds.extend(point);
+  }
+
+  return !bounds.isEmpty();
+}
+
+bool getBaseFootprint(const tesseract_environment::Environment& env, const std::string& base_link_name,
+                      FloorShape& footprint)
+{
+  tesseract_scene_graph::Link::ConstPtr base_link = env.getSceneGraph()->getLink(base_link_name);
+  if (base_link == nullptr)
+    return false;
+
+  Eigen::Isometry3d base_tf;
+  base_tf.setIdentity();
+  base_tf.translation() = Eigen::Vector3d(0, 0, BASE_HEIGHT);
+
+  std::vector<FloorShape> shapes;
+  getLinkFloorShapes(*base_link, base_tf, shapes);
+  if (shapes.empty())
+    return false;
+
+  FloorPolygon outline;
+  footprint.z_min = std::numeric_limits<double>::max();
+  footprint.z_max = -std::numeric_limits<double>::max();
+  for (const auto& shape : shapes)
+  {
+    outline.insert(outline.end(), shape.hull.begin(), shape.hull.end());
+    footprint.z_min = std::min(footprint.z_min, shape.z_min);
+    footprint.z_max = std::max(footprint.z_max, shape.z_max);
+  }
+  footprint.hull = convexHull(outline);
+  return true;
+}
+
+void rasteriseShape(const FloorShape& shape, const FloorShape& footprint, const MapInfo& map,
+                    std::vector<std::size_t>& cells)
+{
+  if (shape.z_max < footprint.z_min || shape.z_min > footprint.z_max)
+    return;
+
+  // the base at c touches the shape iff c lies in shape - footprint
+  FloorPolygon sum;
+  sum.reserve(shape.hull.size() * footprint.hull.size());
+  for (const auto& p : shape.hull)
+  {
+    for (const auto& f : footprint.hull)
+      sum.push_back(p - f);
+  }
+  FloorPolygon region = convexHull(sum);
+  if (region.size() < 3)
+    return;
+
+  double y_min = std::numeric_limits<double>::max();
+  double y_max = -std::numeric_limits<double>::max();
+  for (const auto& p : region)
+  {
+    y_min = std::min(y_min, p.y());
+    y_max = std::max(y_max, p.y());
+  }
+
+  const double origin_x = map.toWorldX(0);
+  const double origin_y = map.toWorldY(0);
+  int y_first = std::max(0, int(std::ceil((y_min - origin_y) / map.step_size - RASTER_EPSILON)));
+  int y_last = std::min(map.grid_size_y - 1, int(std::floor((y_max - origin_y) / map.step_size + RASTER_EPSILON)));
+
+  std::size_t n = region.size();
+  for (int y = y_first; y <= y_last; ++y)
+  {
+    // the row crosses a convex region in a single interval
+    double row = map.toWorldY(y);
+    double x_min = std::numeric_limits<double>::max();
+    double x_max = -std::numeric_limits<double>::max();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const Eigen::Vector2d& a = region[i];
+      const Eigen::Vector2d& b = region[(i + 1) % n];
+      if ((a.y() > row + RASTER_EPSILON && b.y() > row + RASTER_EPSILON) || (a.y() < row - RASTER_EPSILON && b.y() < row - RASTER_EPSILON))
+        continue;
+
+      if (std::abs(b.y() - a.y()) < RASTER_EPSILON)
+      {
+        x_min = std::min(x_min, std::min(a.x(), b.x()));
+        x_max = std::max(x_max, std::max(a.x(), b.x()));
+      }
+      else
+      {
+        double t = std::min(1.0, std::max(0.0, (row - a.y()) / (b.y() - a.y())));
+        double x = a.x() + t * (b.x() - a.x());
+        x_min = std::min(x_min, x);
+        x_max = std::max(x_max, x);
+      }
+    }
+    if (x_min > x_max)
+      continue;
+
+    int x_first = std::max(0, int(std::ceil((x_min - origin_x) / map.step_size - RASTER_EPSILON)));
+    int x_last = std::min(map.grid_size_x - 1, int(std::floor((x_max - origin_x) / map.step_size + RASTER_EPSILON)));
+    std::size_t row_start = static_cast<std::size_t>(y) * static_cast<std::size_t>(map.grid_size_x);
+    for (int x = x_first; x <= x_last; ++x)
+      cells.push_back(row_start + static_cast<std::size_t>(x));
+  }
+}
+
+FloorShape placeFootprint(const FloorShape& footprint, const Eigen::Isometry3d& base_tf)
+{
+  Eigen::Vector3d axis = base_tf.rotation() * Eigen::Vector3d::UnitX();
+  Eigen::Rotation2Dd rotation(std::atan2(axis.y(), axis.x()));
+
+  // a rotation keeps the hull convex and counter-clockwise
+  FloorShape placed = footprint;
+  for (auto& point : placed.hull)
+    point = rotation * point + base_tf.translation().head<2>();
+  return placed;
+}
+
+void rasteriseSweptShapes(const std::vector<FloorShape>& shapes, const FloorShape& footprint,
+                          const FloorShape& standing, const MapInfo& map, std::vector<std::size_t>& cells)
+{
+  cells.clear();
+  for (const auto& shape : shapes)
+    rasteriseShape(shape, footprint, map, cells);
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+  std::vector<std::size_t> exempt;
+  rasteriseShape(standing, footprint, map, exempt);
+  std::sort(exempt.begin(), exempt.end());
+
+  std::vector<std::size_t> blocked;
+  std::set_difference(cells.begin(), cells.end(), exempt.begin(), exempt.end(), std::back_inserter(blocked));
+  cells.swap(blocked);
+}
+
+MapInfo fitMapInfo(const tesseract_environment::Environment& env, const std::vector<std::string>& robot_links,
+                   double min_step, double max_step, double margin, std::size_t max_cells)
+{
+  std::string base_link_name = "base_link";
+  Eigen::Vector2d base_position = env.getLinkTransform(base_link_name).translation().head<2>();
+
+  // radii of the base, a base without geometry is treated as a point
+  FloorShape footprint;
+  double inscribed_radius = 0;
+  double circumscribed_radius = 0;
+  if (getBaseFootprint(env, base_link_name, footprint))
+  {
+    inscribed_radius = std::numeric_limits<double>::max();
+    std::size_t n = footprint.hull.size();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      Eigen::Vector2d edge = footprint.hull[(i + 1) % n] - footprint.hull[i];
+      inscribed_radius = std::min(inscribed_radius, std::max(0.0, -cross(edge, footprint.hull[i]) / edge.norm()));
+      circumscribed_radius = std::max(circumscribed_radius, footprint.hull[i].norm());
+    }
+    if (n < 3)
+      inscribed_radius = 0;
+  }
+  else
+  {
+    footprint.z_min = -std::numeric_limits<double>::max();
+    footprint.z_max = std::numeric_limits<double>::max();
+  }
+
+  // obstacles the base can hit, the floor itself or lamps hanging from the ceiling do not bound the map
+  std::vector<FloorPolygon> obstacles;
+  Eigen::AlignedBox2d bounds(base_position, base_position);
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = env.getSceneGraph();
+  for (const auto& link : scene_graph->getLinks())
+  {
+    if (std::find(robot_links.begin(), robot_links.end(), link->getName()) != robot_links.end() ||
+        !scene_graph->getLinkCollisionEnabled(link->getName()))
+      continue;
+
+    std::vector<FloorShape> shapes;
+    getLinkFloorShapes(*link, env.getLinkTransform(link->getName()), shapes);
+    FloorPolygon link_points;
+    for (const auto& shape : shapes)
+    {
+      if (shape.z_max < footprint.z_min || shape.z_min > footprint.z_max)
+        continue;
+      link_points.insert(link_points.end(), shape.hull.begin(), shape.hull.end());
+    }
+    if (link_points.empty())
+      continue;
+
+    obstacles.push_back(convexHull(link_points));
+    for (const auto& point : link_points)
+      bounds.extend(point);
+  }
+
+  // gaps between obstacles that are wide enough for the base but leave little room need finer cells,
+  // a cell center should fit into the room left on either side of the base; gaps are measured between
+  // the hulls, bounding boxes close the gaps between rotated or diagonally placed obstacles
+  double step = max_step;
+  for (std::size_t i = 0; i < obstacles.size(); ++i)
+  {
+    for (std::size_t j = i + 1; j < obstacles.size(); ++j)
+    {
+      double room = polygonDistance(obstacles[i], obstacles[j]) - 2.0 * inscribed_radius;
+      if (room > 0 && room / 2.0 < step)
+        step = room / 2.0;
+    }
+  }
+  step = std::max(min_step, step);
+
+  // a single narrow gap must not refine the whole map beyond the cell budget
+  double padding = margin + circumscribed_radius;
+  double area = (bounds.sizes().x() + 2.0 * padding) * (bounds.sizes().y() + 2.0 * padding);
+  if (max_cells > 0)
+    step = std::min(max_step, std::max(step, std::sqrt(area / static_cast<double>(max_cells))));
+
+  return MapInfo::fromBounds(bounds.min().x() - padding, bounds.min().y() - padding, bounds.max().x() + padding,
+                             bounds.max().y() + padding, step);
+}
+
+}  // namespace vkc
@@ -0,0 +1,361 @@
+#include <vkc/planner/grid_layer_file.h>
+
+#include <tesseract_geometry/geometries.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vkc
+{
+namespace
+{
+const char MAGIC[8] = { 'V', 'K', 'C', 'G', 'R', 'I', 'D', '\0' };
+
+struct FileHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t layer_count;
+  std::uint64_t geometry_hash;
+  double origin_x;
+  double origin_y;
+  double step_size;
+  std::int32_t grid_size_x;
+  std::int32_t grid_size_y;
+};
+
+struct LayerEntry
+{
+  std::uint32_t type;
+  std::uint32_t reserved;
+  std::uint64_t offset;
+};
+
+std::uint64_t align(std::uint64_t offset)
+{
+  return (offset + 7) & ~std::uint64_t(7);
+}
+
+std::size_t cellSize(GridLayerType type)
+{
+  return type == GridLayerType::OCCUPANCY ? sizeof(std::int8_t) : sizeof(float);
+}
+
+// FNV-1a, stable across runs and platforms of the same byte order
+class GeometryHash
+{
+public:
+  GeometryHash() : value_(14695981039346656037ULL)
+  {
+  }
+
+  void add(const void* data, std::size_t size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      value_ ^= bytes[i];
+      value_ *= 1099511628211ULL;
+    }
+  }
+
+  void add(double value)
+  {
+    add(&value, sizeof(value));
+  }
+
+  void add(const std::string& value)
+  {
+    add(value.data(), value.size());
+  }
+
+  void add(const Eigen::Isometry3d& tf)
+  {
+    add(tf.matrix().data(), sizeof(double) * 16);
+  }
+
+  std::uint64_t value() const
+  {
+    return value_;
+  }
+
+private:
+  std::uint64_t value_;
+};
+}  // namespace
+
+bool writeGridLayers(const std::string& path, const MapInfo& map, std::uint64_t geometry_hash,
+                     const std::vector<const std::vector<std::int8_t>*>& occupancy_layers,
+                     const std::vector<const std::vector<float>*>& cost_layers)
+{
+  std::size_t cell_count = static_cast<std::size_t>(map.grid_size_x) * static_cast<std::size_t>(map.grid_size_y);
+  for (auto layer : occupancy_layers)
+  {
+    if (layer == nullptr || layer->size() != cell_count)
+      return false;
+  }
+  for (auto layer : cost_layers)
+  {
+    if (layer == nullptr || layer->size() != cell_count)
+      return false;
+  }
+
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = GRID_LAYER_FILE_VERSION;
+  header.layer_count = static_cast<std::uint32_t>(occupancy_layers.size() + cost_layers.size());
+  header.geometry_hash = geometry_hash;
+  header.origin_x = map.origin_x;
+  header.origin_y = map.origin_y;
+  header.step_size = map.step_size;
+  header.grid_size_x = map.grid_size_x;
+  header.grid_size_y = map.grid_size_y;
+
+  std::vector<LayerEntry> entries;
+  std::vector<const void*> cells;
+  std::uint64_t offset = align(sizeof(FileHeader) + header.layer_count * sizeof(LayerEntry));
+  for (auto layer : occupancy_layers)
+  {
+    entries.push_back(LayerEntry{ static_cast<std::uint32_t>(GridLayerType::OCCUPANCY), 0, offset });
+    cells.push_back(layer->data());
+    offset = align(offset + cell_count * cellSize(GridLayerType::OCCUPANCY));
+  }
+  for (auto layer : cost_layers)
+  {
+    entries.push_back(LayerEntry{ static_cast<std::uint32_t>(GridLayerType::COST), 0, offset });
+    cells.push_back(layer->data());
+    offset = align(offset + cell_count * cellSize(GridLayerType::COST));
+  }
+
+  // write next to the target and move it into place once complete
+  std::string temp_path = path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file)
+      return false;
+
+    const char padding[8] = { 0 };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(LayerEntry)));
+    std::uint64_t position = sizeof(header) + entries.size() * sizeof(LayerEntry);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+      file.write(padding, static_cast<std::streamsize>(entries[i].offset - position));
+      std::size_t size = cell_count * cellSize(static_cast<GridLayerType>(entries[i].type));
+      file.write(static_cast<const char*>(cells[i]), static_cast<std::streamsize>(size));
+      position = entries[i].offset + size;
+    }
+    if (!file)
+      return false;
+  }
+
+  return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+MappedGridLayers::MappedGridLayers() : data_(nullptr), size_(0), map_(0, 0, 1.0), geometry_hash_(0)
+{
+}
+
+MappedGridLayers::~MappedGridLayers()
+{
+  close();
+}
+
+bool MappedGridLayers::open(const std::string& path)
+{
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat status;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(FileHeader))
+    data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid without the descriptor
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  data_ = static_cast<const unsigned char*>(data);
+  size_ = static_cast<std::size_t>(status.st_size);
+
+  FileHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != GRID_LAYER_FILE_VERSION ||
+      header.grid_size_x <= 0 || header.grid_size_y <= 0 ||
+      sizeof(FileHeader) + header.layer_count * sizeof(LayerEntry) > size_)
+  {
+    close();
+    return false;
+  }
+
+  map_ = MapInfo(0, 0, header.step_size);
+  map_.origin_x = header.origin_x;
+  map_.origin_y = header.origin_y;
+  map_.grid_size_x = header.grid_size_x;
+  map_.grid_size_y = header.grid_size_y;
+  map_.map_x = (header.grid_size_x - 1) * header.step_size;
+  map_.map_y = (header.grid_size_y - 1) * header.step_size;
+  geometry_hash_ = header.geometry_hash;
+
+  std::size_t cell_count = static_cast<std::size_t>(map_.grid_size_x) * static_cast<std::size_t>(map_.grid_size_y);
+  for (std::uint32_t i = 0; i < header.layer_count; ++i)
+  {
+    LayerEntry entry;
+    std::memcpy(&entry, data_ + sizeof(FileHeader) + i * sizeof(LayerEntry), sizeof(entry));
+    if (entry.type > static_cast<std::uint32_t>(GridLayerType::COST) ||
+        entry.offset + cell_count * cellSize(static_cast<GridLayerType>(entry.type)) > size_)
+    {
+      close();
+      return false;
+    }
+    types_.push_back(static_cast<GridLayerType>(entry.type));
+    offsets_.push_back(entry.offset);
+  }
+  return true;
+}
+
+void MappedGridLayers::close()
+{
+  if (data_ != nullptr)
+    munmap(const_cast<unsigned char*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+  types_.clear();
+  offsets_.clear();
+}
+
+bool MappedGridLayers::isOpen() const
+{
+  return data_ != nullptr;
+}
+
+const MapInfo& MappedGridLayers::getMapInfo() const
+{
+  return map_;
+}
+
+std::uint64_t MappedGridLayers::getGeometryHash() const
+{
+  return geometry_hash_;
+}
+
+std::size_t MappedGridLayers::getLayerCount() const
+{
+  return types_.size();
+}
+
+GridLayerType MappedGridLayers::getLayerType(std::size_t layer) const
+{
+  return types_.at(layer);
+}
+
+const std::int8_t* MappedGridLayers::getOccupancy(std::size_t layer) const
+{
+  if (layer >= types_.size() || types_[layer] != GridLayerType::OCCUPANCY)
+    return nullptr;
+  return reinterpret_cast<const std::int8_t*>(data_ + offsets_[layer]);
+}
+
+const float* MappedGridLayers::getCost(std::size_t layer) const
+{
+  if (layer >= types_.size() || types_[layer] != GridLayerType::COST)
+    return nullptr;
+  return reinterpret_cast<const float*>(data_ + offsets_[layer]);
+}
+
+std::uint64_t hashCollisionGeometry(const tesseract_environment::Environment& env,
+                                    const std::vector<std::string>& link_names,
+                                    const std::vector<std::string>& shape_links)
+{
+  std::vector<std::pair<std::string, bool>> links;
+  for (const auto& link_name : link_names)
+    links.emplace_back(link_name, true);
+  for (const auto& link_name : shape_links)
+    links.emplace_back(link_name, false);
+
+  GeometryHash hash;
+  for (const auto& entry : links)
+  {
+    const std::string& link_name = entry.first;
+    tesseract_scene_graph::Link::ConstPtr link = env.getSceneGraph()->getLink(link_name);
+    if (link == nullptr)
+      continue;
+
+    hash.add(link_name);
+    if (entry.second)
+      hash.add(env.getLinkTransform(link_name));
+    for (const auto& collision : link->collision)
+    {
+      tesseract_geometry::GeometryType type = collision->geometry->getType();
+      hash.add(static_cast<double>(static_cast<int>(type)));
+      hash.add(collision->origin);
+      switch (type)
+      {
+        case tesseract_geometry::GeometryType::BOX:
+        {
+          auto box = std::static_pointer_cast<const tesseract_geometry::Box>(collision->geometry);
+          hash.add(box->getX());
+          hash.add(box->getY());
+          hash.add(box->getZ());
+          break;
+        }
+        case tesseract_geometry::GeometryType::SPHERE:
+        {
+          auto sphere = std::static_pointer_cast<const tesseract_geometry::Sphere>(collision->geometry);
+          hash.add(sphere->getRadius());
+          break;
+        }
+        case tesseract_geometry::GeometryType::CYLINDER:
+        {
+          auto cylinder = std::static_pointer_cast<const tesseract_geometry::Cylinder>(collision->geometry);
+          hash.add(cylinder->getRadius());
+          hash.add(cylinder->getLength());
+          break;
+        }
+        case tesseract_geometry::GeometryType::CONE:
+        {
+          auto cone = std::static_pointer_cast<const tesseract_geometry::Cone>(collision->geometry);
+          hash.add(cone->getRadius());
+          hash.add(cone->getLength());
+          break;
+        }
+        case tesseract_geometry::GeometryType::PLANE:
+        {
+          auto plane = std::static_pointer_cast<const tesseract_geometry::Plane>(collision->geometry);
+          hash.add(plane->getA());
+          hash.add(plane->getB());
+          hash.add(plane->getC());
+          hash.add(plane->getD());
+          break;
+        }
+        case tesseract_geometry::GeometryType::MESH:
+        case tesseract_geometry::GeometryType::CONVEX_MESH:
+        case tesseract_geometry::GeometryType::SDF_MESH:
+        {
+          auto mesh = std::static_pointer_cast<const tesseract_geometry::PolygonMesh>(collision->geometry);
+          for (const auto& vertex : *(mesh->getVertices()))
+            hash.add(vertex.data(), sizeof(double) * 3);
+          break;
+        }
+        default:
+          return 0;
+      }
+    }
+  }
+
+  // 0 is reserved for geometry that cannot be identified
+  return hash.value() == 0 ? 1 : hash.value();
+}
+
+}  // namespace vkc
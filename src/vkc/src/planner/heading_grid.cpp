@@ -0,0 +1,201 @@
+#include <vkc/planner/heading_grid.h>
+#include <vkc/planner/occupancy_builder.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace vkc
+{
+HeadingGrid::HeadingGrid(const MapInfo& map, int heading_count) : map_(map), heading_count_(std::max(1, heading_count))
+{
+}
+
+bool HeadingGrid::build(VKCEnvBasic& env, const std::vector<FloorShape>& swept_shapes)
+{
+  std::string base_link_name = "base_link";
+  layers_.clear();
+
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = environment->getSceneGraph();
+  std::vector<std::string> robot_links =
+      env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+
+  FloorShape footprint;
+  if (!getBaseFootprint(*environment, base_link_name, footprint))
+    return false;
+
+  std::vector<FloorShape> shapes;
+  for (const auto& link : scene_graph->getLinks())
+  {
+    if (std::find(robot_links.begin(), robot_links.end(), link->getName()) != robot_links.end() ||
+        !scene_graph->getLinkCollisionEnabled(link->getName()))
+      continue;
+
+    if (!getLinkFloorShapes(*link, environment->getLinkTransform(link->getName()), shapes))
+      return false;
+  }
+
+  FloorShape standing = placeFootprint(footprint, environment->getLinkTransform(base_link_name));
+
+  std::size_t cell_count = static_cast<std::size_t>(map_.grid_size_x) * static_cast<std::size_t>(map_.grid_size_y);
+  layers_.assign(static_cast<std::size_t>(heading_count_), AStar::CollisionMap(cell_count, 0));
+  std::vector<std::size_t> cells;
+  for (int heading = 0; heading < heading_count_; ++heading)
+  {
+    // a rotation keeps the hull convex and counter-clockwise
+    FloorShape rotated = footprint;
+    Eigen::Rotation2Dd rotation(getHeadingAngle(heading));
+    for (auto& point : rotated.hull)
+      point = rotation * point;
+
+    cells.clear();
+    for (const auto& shape : shapes)
+      rasteriseShape(shape, rotated, map_, cells);
+
+    AStar::CollisionMap& layer = layers_[static_cast<std::size_t>(heading)];
+    for (auto cell : cells)
+      layer[cell] = 100;
+
+    if (swept_shapes.empty())
+      continue;
+    rasteriseSweptShapes(swept_shapes, rotated, standing, map_, cells);
+    for (auto cell : cells)
+      layer[cell] = 100;
+  }
+  return true;
+}
+
+const MapInfo& HeadingGrid::getMapInfo() const
+{
+  return map_;
+}
+
+int HeadingGrid::getHeadingCount() const
+{
+  return heading_count_;
+}
+
+double HeadingGrid::getHeadingAngle(int heading) const
+{
+  return 2.0 * M_PI * heading / heading_count_;
+}
+
+int HeadingGrid::toHeading(double angle) const
+{
+  int heading = static_cast<int>(std::lround(angle / (2.0 * M_PI) * heading_count_)) % heading_count_;
+  return heading < 0 ? heading + heading_count_ : heading;
+}
+
+bool HeadingGrid::isFree(int x, int y, int heading) const
+{
+  if (x < 0 || x >= map_.grid_size_x || y < 0 || y >= map_.grid_size_y || heading < 0 ||
+      heading >= static_cast<int>(layers_.size()))
+    return false;
+  return layers_[static_cast<std::size_t>(heading)]
+                [static_cast<std::size_t>(y) * static_cast<std::size_t>(map_.grid_size_x) + static_cast<std::size_t>(x)] ==
+         0;
+}
+
+const AStar::CollisionMap& HeadingGrid::getLayer(int heading) const
+{
+  return layers_.at(static_cast<std::size_t>(heading));
+}
+
+bool HeadingGrid::findPath(const State& start, int goal_x, int goal_y, int goal_heading, Path& path) const
+{
+  path.clear();
+  if (layers_.empty())
+    return false;
+
+  auto passable = [&](int x, int y, int heading) {
+    return isFree(x, y, heading) || (x == start.x && y == start.y) || (x == goal_x && y == goal_y);
+  };
+  auto is_goal = [&](const State& state) {
+    return state.x == goal_x && state.y == goal_y && (goal_heading < 0 || state.heading == goal_heading);
+  };
+  auto heuristic = [&](int x, int y) { return std::hypot(x - goal_x, y - goal_y); };
+
+  if (start.x < 0 || start.x >= map_.grid_size_x || start.y < 0 || start.y >= map_.grid_size_y ||
+      goal_x < 0 || goal_x >= map_.grid_size_x || goal_y < 0 || goal_y >= map_.grid_size_y)
+    return false;
+
+  // dense bookkeeping, the lattice is small enough and hashing states would cost more than it saves
+  std::size_t state_count = layers_.size() * layers_.front().size();
+  std::vector<double> cost(state_count, std::numeric_limits<double>::infinity());
+  std::vector<std::size_t> parent(state_count, state_count);
+  std::vector<bool> closed(state_count, false);
+
+  using QueueEntry = std::pair<double, std::size_t>;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> open;
+
+  std::size_t start_index = stateIndex(start.x, start.y, start.heading);
+  cost[start_index] = 0;
+  open.push(QueueEntry(heuristic(start.x, start.y), start_index));
+
+  const int moves[8][2] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 }, { 1, 1 }, { -1, 1 }, { -1, -1 }, { 1, -1 } };
+  std::size_t cells_per_layer = layers_.front().size();
+  std::size_t width = static_cast<std::size_t>(map_.grid_size_x);
+
+  std::size_t goal_index = state_count;
+  while (!open.empty())
+  {
+    std::size_t index = open.top().second;
+    open.pop();
+    if (closed[index])
+      continue;
+    closed[index] = true;
+
+    State state{ static_cast<int>((index % cells_per_layer) % width), static_cast<int>((index % cells_per_layer) / width),
+                 static_cast<int>(index / cells_per_layer) };
+    if (is_goal(state))
+    {
+      goal_index = index;
+      break;
+    }
+
+    auto relax = [&](int x, int y, int heading, double step) {
+      if (!passable(x, y, heading))
+        return;
+      std::size_t next = stateIndex(x, y, heading);
+      if (closed[next] || cost[index] + step >= cost[next])
+        return;
+      cost[next] = cost[index] + step;
+      parent[next] = index;
+      open.push(QueueEntry(cost[next] + heuristic(x, y), next));
+    };
+
+    for (const auto& move : moves)
+      relax(state.x + move[0], state.y + move[1], state.heading, (move[0] != 0 && move[1] != 0) ? M_SQRT2 : 1.0);
+
+    // turning in place wraps around the full circle
+    if (heading_count_ > 1)
+    {
+      relax(state.x, state.y, (state.heading + 1) % heading_count_, 1.0);
+      relax(state.x, state.y, (state.heading + heading_count_ - 1) % heading_count_, 1.0);
+    }
+  }
+
+  if (goal_index == state_count)
+    return false;
+
+  for (std::size_t index = goal_index; index != state_count; index = parent[index])
+  {
+    path.push_back(State{ static_cast<int>((index % cells_per_layer) % width),
+                          static_cast<int>((index % cells_per_layer) / width),
+                          static_cast<int>(index / cells_per_layer) });
+  }
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+std::size_t HeadingGrid::stateIndex(int x, int y, int heading) const
+{
+  return static_cast<std::size_t>(heading) * layers_.front().size() +
+         static_cast<std::size_t>(y) * static_cast<std::size_t>(map_.grid_size_x) + static_cast<std::size_t>(x);
+}
+
+}  // namespace vkc
@@ -0,0 +1,314 @@
+#include <vkc/planner/ik_solution_cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace vkc
+{
+namespace
+{
+const char MAGIC[8] = { 'V', 'K', 'C', 'I', 'K', 'C', '\0', '\0' };
+
+// stored targets closer than this share one entry
+const double MERGE_DISTANCE = 1e-3;
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value)
+{
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeDoubles(std::ofstream& file, const double* values, std::size_t count)
+{
+  file.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(count * sizeof(double)));
+}
+
+bool readDoubles(std::ifstream& file, double* values, std::size_t count)
+{
+  return static_cast<bool>(
+      file.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(count * sizeof(double))));
+}
+}  // namespace
+
+IKSolutionCache::IKSolutionCache(double orientation_weight, std::size_t max_entries)
+  : orientation_weight_(orientation_weight), max_entries_(max_entries), scene_key_(0), modified_(false)
+{
+}
+
+IKSolutionCache::Key IKSolutionCache::makeKey(const Target& target) const
+{
+  Eigen::Matrix3d rotation = Eigen::Quaterniond(target(3), target(4), target(5), target(6)).toRotationMatrix();
+
+  // the chordal distance of an axis is 2 sin(angle / 2), the two axes together about sqrt(2) times the angle
+  double weight = orientation_weight_ / std::sqrt(2.0);
+  Key key;
+  key << target.head<3>(), weight * rotation.col(0), weight * rotation.col(1);
+  return key;
+}
+
+std::string IKSolutionCache::getChainKey(const std::vector<std::string>& joint_names)
+{
+  std::string key;
+  for (const auto& joint_name : joint_names)
+  {
+    key += joint_name;
+    key += '\n';
+  }
+  return key;
+}
+
+void IKSolutionCache::add(const std::vector<std::string>& joint_names, const Eigen::Isometry3d& target,
+                          const Eigen::VectorXd& solution)
+{
+  if (static_cast<std::size_t>(solution.size()) != joint_names.size())
+    return;
+
+  Eigen::Quaterniond rotation(target.rotation());
+  Target stored;
+  stored << target.translation(), rotation.w(), rotation.x(), rotation.y(), rotation.z();
+
+  Chain& chain = chains_[getChainKey(joint_names)];
+  chain.joint_names = joint_names;
+  insert(chain, stored, solution);
+  modified_ = true;
+}
+
+void IKSolutionCache::insert(Chain& chain, const Target& target, const Eigen::VectorXd& solution)
+{
+  Key key = makeKey(target);
+  std::vector<int> nearest = findNearest(chain, key, 1, MERGE_DISTANCE);
+  if (!nearest.empty())
+  {
+    chain.nodes[static_cast<std::size_t>(nearest.front())].solution = solution;
+    return;
+  }
+  if (chain.nodes.size() >= max_entries_)
+    return;
+
+  int index = static_cast<int>(chain.nodes.size());
+  chain.nodes.push_back(Node{ key, target, solution, -1, -1 });
+  if (index == 0)
+    return;
+
+  int parent = 0;
+  for (int depth = 0;; ++depth)
+  {
+    Node& node = chain.nodes[static_cast<std::size_t>(parent)];
+    int& child = key(depth % 9) < node.key(depth % 9) ? node.left : node.right;
+    if (child < 0)
+    {
+      child = index;
+      return;
+    }
+    parent = child;
+  }
+}
+
+std::vector<int> IKSolutionCache::findNearest(const Chain& chain, const Key& key, std::size_t k,
+                                              double max_distance) const
+{
+  std::vector<int> result;
+  if (chain.nodes.empty() || k == 0)
+    return result;
+
+  // max heap of the best nodes so far, by squared distance
+  std::priority_queue<std::pair<double, int>> best;
+  double max_distance_2 = max_distance * max_distance;
+  auto bound = [&]() { return best.size() < k ? max_distance_2 : std::min(max_distance_2, best.top().first); };
+
+  std::vector<std::pair<int, int>> stack(1, std::make_pair(0, 0));
+  while (!stack.empty())
+  {
+    int index = stack.back().first;
+    int depth = stack.back().second;
+    stack.pop_back();
+    if (index < 0)
+      continue;
+
+    const Node& node = chain.nodes[static_cast<std::size_t>(index)];
+    double distance_2 = (node.key - key).squaredNorm();
+    if (distance_2 <= bound())
+    {
+      best.emplace(distance_2, index);
+      if (best.size() > k)
+        best.pop();
+    }
+
+    // the near side is searched first, the far side only if the splitting plane is within reach
+    double offset = key(depth % 9) - node.key(depth % 9);
+    int near_child = offset < 0 ? node.left : node.right;
+    int far_child = offset < 0 ? node.right : node.left;
+    if (offset * offset <= bound())
+      stack.emplace_back(far_child, depth + 1);
+    stack.emplace_back(near_child, depth + 1);
+  }
+
+  result.resize(best.size());
+  for (std::size_t i = best.size(); i > 0; --i)
+  {
+    result[i - 1] = best.top().second;
+    best.pop();
+  }
+  return result;
+}
+
+std::vector<Eigen::VectorXd> IKSolutionCache::getNearest(const std::vector<std::string>& joint_names,
+                                                         const Eigen::Isometry3d& target, std::size_t k,
+                                                         double max_distance) const
+{
+  std::vector<Eigen::VectorXd> solutions;
+  auto chain = chains_.find(getChainKey(joint_names));
+  if (chain == chains_.end())
+    return solutions;
+
+  Eigen::Quaterniond rotation(target.rotation());
+  Target query;
+  query << target.translation(), rotation.w(), rotation.x(), rotation.y(), rotation.z();
+  for (int index : findNearest(chain->second, makeKey(query), k, max_distance))
+    solutions.push_back(chain->second.nodes[static_cast<std::size_t>(index)].solution);
+  return solutions;
+}
+
+std::size_t IKSolutionCache::size() const
+{
+  std::size_t count = 0;
+  for (const auto& chain : chains_)
+    count += chain.second.nodes.size();
+  return count;
+}
+
+bool IKSolutionCache::setStorageFile(const std::string& path, std::uint64_t scene_key)
+{
+  if (path == storage_file_ && scene_key == scene_key_)
+    return true;
+
+  save();
+  chains_.clear();
+  modified_ = false;
+  storage_file_ = scene_key != 0 ? path : std::string();
+  scene_key_ = scene_key;
+  if (storage_file_.empty())
+    return true;
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file || load(path))
+    return true;
+
+  // a partly read file of the same scene is not trusted
+  chains_.clear();
+  return false;
+}
+
+std::uint64_t IKSolutionCache::getSceneKey() const
+{
+  return scene_key_;
+}
+
+bool IKSolutionCache::load(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  char magic[8];
+  std::uint32_t version = 0;
+  std::uint64_t scene_key = 0;
+  std::uint32_t chain_count = 0;
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !readValue(file, version) || version != IK_SOLUTION_CACHE_VERSION || !readValue(file, scene_key))
+    return false;
+
+  // solutions of another scene are dropped, the file is replaced by the next save
+  if (scene_key != scene_key_)
+    return true;
+  if (!readValue(file, chain_count))
+    return false;
+
+  for (std::uint32_t i = 0; i < chain_count; ++i)
+  {
+    std::uint32_t joint_count = 0;
+    if (!readValue(file, joint_count))
+      return false;
+
+    std::vector<std::string> joint_names(joint_count);
+    for (auto& joint_name : joint_names)
+    {
+      std::uint32_t length = 0;
+      if (!readValue(file, length))
+        return false;
+      joint_name.resize(length);
+      if (length > 0 && !file.read(&joint_name[0], length))
+        return false;
+    }
+
+    std::uint32_t entry_count = 0;
+    if (!readValue(file, entry_count))
+      return false;
+
+    Chain& chain = chains_[getChainKey(joint_names)];
+    chain.joint_names = joint_names;
+    for (std::uint32_t j = 0; j < entry_count; ++j)
+    {
+      Target target;
+      Eigen::VectorXd solution(joint_count);
+      if (!readDoubles(file, target.data(), 7) || !readDoubles(file, solution.data(), joint_count))
+        return false;
+      insert(chain, target, solution);
+    }
+  }
+  return true;
+}
+
+bool IKSolutionCache::save()
+{
+  if (storage_file_.empty() || !modified_)
+    return true;
+
+  // write next to the target and move it into place once complete
+  std::string temp_path = storage_file_ + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file)
+      return false;
+
+    file.write(MAGIC, sizeof(MAGIC));
+    writeValue(file, IK_SOLUTION_CACHE_VERSION);
+    writeValue(file, scene_key_);
+    writeValue(file, static_cast<std::uint32_t>(chains_.size()));
+    for (const auto& entry : chains_)
+    {
+      const Chain& chain = entry.second;
+      writeValue(file, static_cast<std::uint32_t>(chain.joint_names.size()));
+      for (const auto& joint_name : chain.joint_names)
+      {
+        writeValue(file, static_cast<std::uint32_t>(joint_name.size()));
+        file.write(joint_name.data(), static_cast<std::streamsize>(joint_name.size()));
+      }
+
+      writeValue(file, static_cast<std::uint32_t>(chain.nodes.size()));
+      for (const auto& node : chain.nodes)
+      {
+        writeDoubles(file, node.target.data(), 7);
+        writeDoubles(file, node.solution.data(), static_cast<std::size_t>(node.solution.size()));
+      }
+    }
+    if (!file)
+      return false;
+  }
+
+  if (std::rename(temp_path.c_str(), storage_file_.c_str()) != 0)
+    return false;
+  modified_ = false;
+  return true;
+}
+
+}  // namespace vkc
@@ -0,0 +1,140 @@
+#include <vkc/planner/incremental_base_grid.h>
+#include <vkc/planner/occupancy_builder.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace vkc
+{
+IncrementalBaseGrid::IncrementalBaseGrid(const MapInfo& map)
+  : map_(map)
+  , has_footprint_(false)
+  , cover_(static_cast<std::size_t>(map.grid_size_x) * static_cast<std::size_t>(map.grid_size_y), 0)
+  , has_static_layer_(false)
+  , updated_links_(0)
+{
+}
+
+bool IncrementalBaseGrid::update(VKCEnvBasic& env)
+{
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = environment->getSceneGraph();
+  std::vector<std::string> robot_links =
+      env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+
+  // the base does not change shape, its footprint only has to be found once
+  if (!has_footprint_)
+    has_footprint_ = getBaseFootprint(*environment, "base_link", footprint_);
+  if (!has_footprint_)
+    return false;
+
+  // the split of the scene is fixed, so is the static layer of the layout once it has been looked up
+  if (!has_static_layer_)
+  {
+    static_layer_ = env.getStaticBaseLayer();
+    if (static_layer_ != nullptr)
+      static_cells_ = static_layer_->getLayer(*environment, map_);
+    if (static_cells_ == nullptr)
+      static_layer_ = nullptr;
+    has_static_layer_ = true;
+  }
+
+  updated_links_ = 0;
+  bool supported = true;
+  std::unordered_set<std::string> obstacles;
+  for (const auto& link : scene_graph->getLinks())
+  {
+    const std::string& link_name = link->getName();
+    if (link->collision.empty() || !scene_graph->getLinkCollisionEnabled(link_name) ||
+        std::find(robot_links.begin(), robot_links.end(), link_name) != robot_links.end() ||
+        (static_layer_ != nullptr && static_layer_->isStatic(link_name)))
+      continue;
+
+    obstacles.insert(link_name);
+    const Eigen::Isometry3d& tf = environment->getLinkTransform(link_name);
+
+    auto it = links_.find(link_name);
+    if (it == links_.end())
+    {
+      it = links_.insert(std::make_pair(link_name, LinkCells())).first;
+    }
+    else if (it->second.tf.isApprox(tf, 1e-9))
+    {
+      supported = supported && it->second.supported;
+      continue;
+    }
+    else
+    {
+      removeLink(it->second);
+    }
+
+    addLink(*link, tf, it->second);
+    supported = supported && it->second.supported;
+    ++updated_links_;
+  }
+
+  // links that became part of the robot or were removed from the scene
+  for (auto it = links_.begin(); it != links_.end();)
+  {
+    if (obstacles.count(it->first) > 0)
+    {
+      ++it;
+      continue;
+    }
+    removeLink(it->second);
+    it = links_.erase(it);
+    ++updated_links_;
+  }
+
+  return supported;
+}
+
+void IncrementalBaseGrid::exportTo(AStar::Generator& astar_generator) const
+{
+  AStar::CollisionMap cells(cover_.size());
+  std::transform(cover_.begin(), cover_.end(), cells.begin(),
+                 [](std::uint16_t cover) { return static_cast<std::int8_t>(cover > 0 ? 100 : 0); });
+  if (static_cells_ != nullptr)
+  {
+    std::transform(cells.begin(), cells.end(), static_cells_.get(), cells.begin(),
+                   [](std::int8_t cell, std::int8_t static_cell) { return std::max(cell, static_cell); });
+  }
+
+  astar_generator.setWorldSize({ map_.grid_size_x, map_.grid_size_y });
+  astar_generator.swapCollisionMap(cells);
+}
+
+const MapInfo& IncrementalBaseGrid::getMapInfo() const
+{
+  return map_;
+}
+
+std::size_t IncrementalBaseGrid::getUpdatedLinkCount() const
+{
+  return updated_links_;
+}
+
+void IncrementalBaseGrid::addLink(const tesseract_scene_graph::Link& link, const Eigen::Isometry3d& tf,
+                                  LinkCells& link_cells)
+{
+  std::vector<FloorShape> shapes;
+  link_cells.tf = tf;
+  link_cells.supported = getLinkFloorShapes(link, tf, shapes);
+  link_cells.cells.clear();
+  for (const auto& shape : shapes)
+    rasteriseShape(shape, footprint_, map_, link_cells.cells);
+
+  // overlapping shapes of one link must not count twice
+  std::sort(link_cells.cells.begin(), link_cells.cells.end());
+  link_cells.cells.erase(std::unique(link_cells.cells.begin(), link_cells.cells.end()), link_cells.cells.end());
+  for (auto cell : link_cells.cells)
+    ++cover_[cell];
+}
+
+void IncrementalBaseGrid::removeLink(const LinkCells& link_cells)
+{
+  for (auto cell : link_cells.cells)
+    --cover_[cell];
+}
+
+}  // namespace vkc
@@ -0,0 +1,242 @@
+#include <vkc/planner/inverse_reachability_map.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace vkc
+{
+namespace
+{
+const char MAGIC[8] = { 'V', 'K', 'C', 'I', 'R', 'M', '\0', '\0' };
+
+std::int64_t packIndices(int a, int b, int c)
+{
+  return (static_cast<std::int64_t>(a + 32768) << 32) | (static_cast<std::int64_t>(b + 32768) << 16) |
+         static_cast<std::int64_t>(c + 32768);
+}
+
+int toIndex(double value, double step)
+{
+  return static_cast<int>(std::lround(value / step));
+}
+
+// rotation = Rz(yaw) * Ry(pitch) * Rx(roll)
+void getYawPitchRoll(const Eigen::Matrix3d& rotation, double& yaw, double& pitch, double& roll)
+{
+  yaw = std::atan2(rotation(1, 0), rotation(0, 0));
+  pitch = std::asin(std::max(-1.0, std::min(1.0, -rotation(2, 0))));
+  roll = std::atan2(rotation(2, 1), rotation(2, 2));
+}
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value)
+{
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value)
+{
+  return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+void writeString(std::ofstream& file, const std::string& value)
+{
+  writeValue(file, static_cast<std::uint32_t>(value.size()));
+  file.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+bool readString(std::ifstream& file, std::string& value)
+{
+  std::uint32_t length = 0;
+  if (!readValue(file, length))
+    return false;
+  value.resize(length);
+  return length == 0 || static_cast<bool>(file.read(&value[0], length));
+}
+}  // namespace
+
+InverseReachabilityMap::InverseReachabilityMap() : position_step_(0.05), angle_step_(M_PI / 12)
+{
+}
+
+std::int64_t InverseReachabilityMap::getVoxel(double z, double roll, double pitch) const
+{
+  return packIndices(toIndex(z, position_step_), toIndex(roll, angle_step_), toIndex(pitch, angle_step_));
+}
+
+bool InverseReachabilityMap::build(const tesseract_kinematics::ForwardKinematics& arm_kin, std::size_t n_samples,
+                                   double position_step, double angle_step, unsigned random_seed)
+{
+  voxels_.clear();
+  base_link_name_ = arm_kin.getBaseLinkName();
+  tip_link_name_ = arm_kin.getTipLinkName();
+  position_step_ = position_step;
+  angle_step_ = angle_step;
+
+  const Eigen::MatrixX2d& limits = arm_kin.getLimits();
+  long n_joints = static_cast<long>(arm_kin.numJoints());
+  std::mt19937 rng(random_seed);
+  std::vector<std::uniform_real_distribution<double>> joint_samplers;
+  for (long j = 0; j < n_joints; ++j)
+    joint_samplers.emplace_back(limits(j, 0), limits(j, 1));
+
+  // headings of the base are wrapped to whole turns of the angle step
+  int n_headings = std::max(1, toIndex(2 * M_PI, angle_step));
+
+  // best manipulability per voxel and base cell
+  std::unordered_map<std::int64_t, std::unordered_map<std::int64_t, double>> scores;
+  double max_score = 0;
+  Eigen::VectorXd joint_values(n_joints);
+  Eigen::MatrixXd jacobian(6, n_joints);
+  Eigen::Isometry3d pose;
+  for (std::size_t i = 0; i < n_samples; ++i)
+  {
+    for (long j = 0; j < n_joints; ++j)
+      joint_values(j) = joint_samplers[static_cast<std::size_t>(j)](rng);
+
+    if (!arm_kin.calcFwdKin(pose, joint_values) || !arm_kin.calcJacobian(jacobian, joint_values))
+      continue;
+    double score = std::sqrt(std::max(0.0, (jacobian * jacobian.transpose()).determinant()));
+    if (score <= 0)
+      continue;
+
+    // the base seen from the end effector, in a frame that turns with the end effector's heading
+    double yaw, pitch, roll;
+    getYawPitchRoll(pose.linear(), yaw, pitch, roll);
+    Eigen::Vector2d offset = Eigen::Rotation2Dd(-yaw) * (-pose.translation().head<2>());
+    int heading = ((toIndex(-yaw, angle_step) % n_headings) + n_headings) % n_headings;
+
+    double& cell_score = scores[getVoxel(pose.translation().z(), roll, pitch)][packIndices(
+        toIndex(offset.x(), position_step), toIndex(offset.y(), position_step), heading)];
+    cell_score = std::max(cell_score, score);
+    max_score = std::max(max_score, score);
+  }
+
+  for (const auto& voxel : scores)
+  {
+    std::vector<Placement>& placements = voxels_[voxel.first];
+    for (const auto& cell : voxel.second)
+    {
+      Placement placement;
+      placement.x = static_cast<std::int16_t>(((cell.first >> 32) & 0xffff) - 32768);
+      placement.y = static_cast<std::int16_t>(((cell.first >> 16) & 0xffff) - 32768);
+      placement.theta = static_cast<std::int16_t>((cell.first & 0xffff) - 32768);
+      placement.score = static_cast<float>(cell.second / max_score);
+      placements.push_back(placement);
+    }
+    std::sort(placements.begin(), placements.end(),
+              [](const Placement& a, const Placement& b) { return a.score > b.score; });
+  }
+  return !voxels_.empty();
+}
+
+bool InverseReachabilityMap::empty() const
+{
+  return voxels_.empty();
+}
+
+const std::string& InverseReachabilityMap::getBaseLinkName() const
+{
+  return base_link_name_;
+}
+
+const std::string& InverseReachabilityMap::getTipLinkName() const
+{
+  return tip_link_name_;
+}
+
+std::vector<InverseReachabilityMap::BasePlacement>
+InverseReachabilityMap::getBasePlacements(const Eigen::Isometry3d& target, double base_z, std::size_t max_count) const
+{
+  std::vector<BasePlacement> result;
+  double yaw, pitch, roll;
+  getYawPitchRoll(target.linear(), yaw, pitch, roll);
+  auto voxel = voxels_.find(getVoxel(target.translation().z() - base_z, roll, pitch));
+  if (voxel == voxels_.end())
+    return result;
+
+  Eigen::Rotation2Dd heading(yaw);
+  for (const auto& placement : voxel->second)
+  {
+    if (result.size() >= max_count)
+      break;
+
+    Eigen::Vector2d offset(placement.x * position_step_, placement.y * position_step_);
+    Eigen::Vector2d position = target.translation().head<2>() + heading * offset;
+    result.push_back(BasePlacement{ position.x(), position.y(),
+                                    std::remainder(yaw + placement.theta * angle_step_, 2 * M_PI), placement.score });
+  }
+  return result;
+}
+
+bool InverseReachabilityMap::save(const std::string& path) const
+{
+  // write next to the target and move it into place once complete
+  std::string temp_path = path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file)
+      return false;
+
+    file.write(MAGIC, sizeof(MAGIC));
+    writeValue(file, INVERSE_REACHABILITY_MAP_VERSION);
+    writeValue(file, position_step_);
+    writeValue(file, angle_step_);
+    writeString(file, base_link_name_);
+    writeString(file, tip_link_name_);
+    writeValue(file, static_cast<std::uint64_t>(voxels_.size()));
+    for (const auto& voxel : voxels_)
+    {
+      writeValue(file, voxel.first);
+      writeValue(file, static_cast<std::uint32_t>(voxel.second.size()));
+      file.write(reinterpret_cast<const char*>(voxel.second.data()),
+                 static_cast<std::streamsize>(voxel.second.size() * sizeof(Placement)));
+    }
+    if (!file)
+      return false;
+  }
+
+  return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+bool InverseReachabilityMap::load(const std::string& path)
+{
+  voxels_.clear();
+
+  std::ifstream file(path, std::ios::binary);
+  char magic[8];
+  std::uint32_t version = 0;
+  std::uint64_t voxel_count = 0;
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      !readValue(file, version) || version != INVERSE_REACHABILITY_MAP_VERSION || !readValue(file, position_step_) ||
+      !readValue(file, angle_step_) || !readString(file, base_link_name_) || !readString(file, tip_link_name_) ||
+      !readValue(file, voxel_count))
+    return false;
+
+  for (std::uint64_t i = 0; i < voxel_count; ++i)
+  {
+    std::int64_t key = 0;
+    std::uint32_t count = 0;
+    if (!readValue(file, key) || !readValue(file, count))
+    {
+      voxels_.clear();
+      return false;
+    }
+
+    std::vector<Placement>& placements = voxels_[key];
+    placements.resize(count);
+    if (!file.read(reinterpret_cast<char*>(placements.data()),
+                   static_cast<std::streamsize>(placements.size() * sizeof(Placement))))
+    {
+      voxels_.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace vkc
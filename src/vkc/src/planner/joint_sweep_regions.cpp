@@ -0,0 +1,118 @@
+#include <vkc/planner/joint_sweep_regions.h>
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <ros/console.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <algorithm>
+#include <cmath>
+
+namespace vkc
+{
+void JointSweepRegions::build(const tesseract_environment::Environment& env,
+                              const std::vector<std::string>& joint_names, double resolution)
+{
+  sweeps_.clear();
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = env.getSceneGraph();
+
+  for (const auto& joint_name : joint_names)
+  {
+    tesseract_scene_graph::Joint::ConstPtr joint = scene_graph->getJoint(joint_name);
+    if (joint == nullptr)
+      continue;
+
+    double lower = 0;
+    double upper = 0;
+    if (joint->type == tesseract_scene_graph::JointType::CONTINUOUS)
+    {
+      lower = -M_PI;
+      upper = M_PI;
+    }
+    else if ((joint->type == tesseract_scene_graph::JointType::REVOLUTE ||
+              joint->type == tesseract_scene_graph::JointType::PRISMATIC) &&
+             joint->limits != nullptr)
+    {
+      lower = joint->limits->lower;
+      upper = joint->limits->upper;
+    }
+    if (upper <= lower)
+      continue;
+
+    std::vector<std::string> moved_links = scene_graph->getLinkChildrenNames(joint->child_link_name);
+    moved_links.push_back(joint->child_link_name);
+
+    JointSweep sweep;
+    sweep.parent_link = joint->parent_link_name;
+    sweep.parent_tf = env.getLinkTransform(joint->parent_link_name);
+
+    int n_segments = std::max(1, static_cast<int>(std::ceil((upper - lower) / resolution)));
+    std::vector<FloorShape> previous;
+    bool supported = true;
+    for (int i = 0; i <= n_segments && supported; ++i)
+    {
+      double position = lower + (upper - lower) * i / n_segments;
+      tesseract_environment::EnvState::Ptr state = env.getState({ { joint_name, position } });
+
+      // links and their shapes come in the same order at every sample
+      std::vector<FloorShape> current;
+      for (const auto& link_name : moved_links)
+      {
+        tesseract_scene_graph::Link::ConstPtr link = scene_graph->getLink(link_name);
+        if (link != nullptr && !getLinkFloorShapes(*link, state->link_transforms.at(link_name), current))
+          supported = false;
+      }
+
+      if (i > 0)
+      {
+        std::vector<FloorShape> segment;
+        for (std::size_t k = 0; k < current.size() && k < previous.size(); ++k)
+        {
+          FloorPolygon points = previous[k].hull;
+          points.insert(points.end(), current[k].hull.begin(), current[k].hull.end());
+          segment.push_back(FloorShape{ convexHull(points), std::min(previous[k].z_min, current[k].z_min),
+                                        std::max(previous[k].z_max, current[k].z_max) });
+        }
+        sweep.segments.push_back(segment);
+      }
+      sweep.positions.push_back(position);
+      previous.swap(current);
+    }
+
+    if (!supported)
+    {
+      ROS_WARN("Links moved by joint %s cannot be projected on the floor, its sweep is left out.", joint_name.c_str());
+      continue;
+    }
+    sweeps_.insert(std::make_pair(joint_name, sweep));
+  }
+}
+
+bool JointSweepRegions::hasJoint(const std::string& joint_name) const
+{
+  return sweeps_.find(joint_name) != sweeps_.end();
+}
+
+bool JointSweepRegions::getSweptShapes(const tesseract_environment::Environment& env, const std::string& joint_name,
+                                       double from, double to, std::vector<FloorShape>& shapes) const
+{
+  auto it = sweeps_.find(joint_name);
+  if (it == sweeps_.end())
+    return false;
+
+  const JointSweep& sweep = it->second;
+  if (!env.getLinkTransform(sweep.parent_link).isApprox(sweep.parent_tf, 1e-6))
+    return false;
+
+  double lower = std::max(std::min(from, to), sweep.positions.front());
+  double upper = std::min(std::max(from, to), sweep.positions.back());
+  for (std::size_t i = 0; i < sweep.segments.size(); ++i)
+  {
+    // a joint that does not move still covers the segment it rests in
+    if (sweep.positions[i] <= upper && sweep.positions[i + 1] >= lower)
+      shapes.insert(shapes.end(), sweep.segments[i].begin(), sweep.segments[i].end());
+  }
+  return true;
+}
+
+}  // namespace vkc
@@ -0,0 +1,64 @@
+#include <vkc/planner/occupancy_builder.h>
+
+#include <algorithm>
+
+namespace vkc
+{
+void rasteriseShape(const FloorShape& shape, const FloorShape& footprint, const MapInfo& map,
+                    AStar::Generator& astar_generator)
+{
+  std::vector<std::size_t> cells;
+  rasteriseShape(shape, footprint, map, cells);
+
+  std::size_t width = static_cast<std::size_t>(map.grid_size_x);
+  for (auto cell : cells)
+    astar_generator.addCollision({ static_cast<int>(cell % width), static_cast<int>(cell / width) });
+}
+
+bool rasteriseBaseGrid(VKCEnvBasic& env, const MapInfo& map, AStar::Generator& astar_generator)
+{
+  std::string base_link_name = "base_link";
+
+  tesseract_environment::Environment::Ptr environment = env.getVKCEnv()->getTesseract()->getEnvironment();
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = environment->getSceneGraph();
+  std::vector<std::string> robot_links =
+      env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+
+  astar_generator.setWorldSize({ map.grid_size_x, map.grid_size_y });
+
+  FloorShape footprint;
+  if (!getBaseFootprint(*environment, base_link_name, footprint))
+    return false;
+
+  // start from the static layer of the scene, only the links that can move are left to rasterise
+  StaticBaseLayer::Ptr static_layer = env.getStaticBaseLayer();
+  StaticBaseLayer::CellsPtr static_cells;
+  if (static_layer != nullptr)
+    static_cells = static_layer->getLayer(*environment, map);
+  if (static_cells != nullptr)
+  {
+    AStar::CollisionMap cells(static_cells.get(), static_cells.get() + static_cast<std::size_t>(map.grid_size_x) *
+                                                                       static_cast<std::size_t>(map.grid_size_y));
+    astar_generator.swapCollisionMap(cells);
+  }
+
+  bool supported = true;
+  for (const auto& link : scene_graph->getLinks())
+  {
+    if (std::find(robot_links.begin(), robot_links.end(), link->getName()) != robot_links.end() ||
+        !scene_graph->getLinkCollisionEnabled(link->getName()) ||
+        (static_cells != nullptr && static_layer->isStatic(link->getName())))
+      continue;
+
+    std::vector<FloorShape> shapes;
+    if (!getLinkFloorShapes(*link, environment->getLinkTransform(link->getName()), shapes))
+      supported = false;
+
+    for (const auto& shape : shapes)
+      rasteriseShape(shape, footprint, map, astar_generator);
+  }
+
+  return supported;
+}
+
+}  // namespace vkc
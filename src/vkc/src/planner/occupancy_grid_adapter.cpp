@@ -0,0 +1,67 @@
+#include <vkc/planner/occupancy_grid_adapter.h>
+
+namespace vkc
+{
+void toMapMetaData(const MapInfo& map, nav_msgs::MapMetaData& info)
+{
+  info.resolution = static_cast<float>(map.step_size);
+  info.width = static_cast<uint32_t>(map.grid_size_x);
+  info.height = static_cast<uint32_t>(map.grid_size_y);
+  // OccupancyGrid places the corner of cell (0, 0) at the origin, while the base grid
+  // places the cell center there.
+  info.origin.position.x = map.toWorldX(0) - map.step_size / 2.0;
+  info.origin.position.y = map.toWorldY(0) - map.step_size / 2.0;
+  info.origin.position.z = 0;
+  info.origin.orientation.x = 0;
+  info.origin.orientation.y = 0;
+  info.origin.orientation.z = 0;
+  info.origin.orientation.w = 1;
+}
+
+MapInfo fromMapMetaData(const nav_msgs::MapMetaData& info)
+{
+  MapInfo map(0, 0, info.resolution);
+  map.grid_size_x = static_cast<int>(info.width);
+  map.grid_size_y = static_cast<int>(info.height);
+  map.map_x = (map.grid_size_x - 1) * map.step_size;
+  map.map_y = (map.grid_size_y - 1) * map.step_size;
+  map.origin_x = info.origin.position.x + map.step_size / 2.0;
+  map.origin_y = info.origin.position.y + map.step_size / 2.0;
+  return map;
+}
+
+bool isCompatible(const MapInfo& map, const nav_msgs::OccupancyGrid& grid)
+{
+  // same origin convention as toMapMetaData(), and no rotation of the grid in the world frame
+  const geometry_msgs::Pose& origin = grid.info.origin;
+  double tolerance = map.step_size * 1e-3;
+  return grid.info.width == static_cast<uint32_t>(map.grid_size_x) &&
+         grid.info.height == static_cast<uint32_t>(map.grid_size_y) &&
+         std::abs(grid.info.resolution - map.step_size) < 1e-6 &&
+         std::abs(origin.position.x - (map.toWorldX(0) - map.step_size / 2.0)) < tolerance &&
+         std::abs(origin.position.y - (map.toWorldY(0) - map.step_size / 2.0)) < tolerance &&
+         std::abs(std::abs(origin.orientation.w) - 1.0) < 1e-6 &&
+         grid.data.size() == static_cast<size_t>(map.grid_size_x) * static_cast<size_t>(map.grid_size_y);
+}
+
+void exportOccupancyGrid(AStar::Generator& generator, const MapInfo& map, nav_msgs::OccupancyGrid& grid)
+{
+  grid.header.frame_id = "world";
+  toMapMetaData(map, grid.info);
+  generator.swapCollisionMap(grid.data);
+}
+
+bool importOccupancyGrid(nav_msgs::OccupancyGrid& grid, const MapInfo& map, AStar::Generator& generator)
+{
+  if (!isCompatible(map, grid))
+  {
+    ROS_WARN("Occupancy grid does not match the base map (%ux%u, %f m, origin %f %f), ignoring it.",
+             grid.info.width, grid.info.height, grid.info.resolution, grid.info.origin.position.x,
+             grid.info.origin.position.y);
+    return false;
+  }
+  generator.setWorldSize({ map.grid_size_x, map.grid_size_y }, grid.data);
+  return true;
+}
+
+}  // namespace vkc
@@ -0,0 +1,390 @@
+#include <vkc/planner/planar_base_ur_inv_kin.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace vkc
+{
+namespace
+{
+// axes closer to parallel or intersecting than this are taken as such when checking the structure of the arm
+const double STRUCTURE_TOLERANCE = 1e-5;
+
+// solutions further than this from the target are dropped
+const double SOLUTION_TOLERANCE = 1e-6;
+
+// angles with a cos(angle) + b sin(angle) = c
+std::vector<double> solveCosSin(double a, double b, double c)
+{
+  std::vector<double> angles;
+  double norm = std::hypot(a, b);
+  if (norm < 1e-12 || std::abs(c) > norm * (1 + 1e-9))
+    return angles;
+
+  double phase = std::atan2(b, a);
+  double offset = std::acos(std::max(-1.0, std::min(1.0, c / norm)));
+  angles.push_back(phase + offset);
+  if (offset > 1e-12)
+    angles.push_back(phase - offset);
+  return angles;
+}
+
+// angle about axis turning from onto to, both projected onto the plane normal to axis
+bool solveRotation(const Eigen::Vector3d& axis, const Eigen::Vector3d& from, const Eigen::Vector3d& to, double& angle)
+{
+  Eigen::Vector3d u = from - axis.dot(from) * axis;
+  Eigen::Vector3d v = to - axis.dot(to) * axis;
+  if (u.norm() < 1e-9 || v.norm() < 1e-9)
+    return false;
+  angle = std::atan2(axis.dot(u.cross(v)), u.dot(v));
+  return true;
+}
+
+Eigen::Isometry3d rotationAbout(const Eigen::Vector3d& axis, const Eigen::Vector3d& point, double angle)
+{
+  Eigen::Isometry3d rotation = Eigen::Isometry3d::Identity();
+  rotation.linear() = Eigen::AngleAxisd(angle, axis).toRotationMatrix();
+  rotation.translation() = point - rotation.linear() * point;
+  return rotation;
+}
+}  // namespace
+
+PlanarBaseURInvKin::Ptr PlanarBaseURInvKin::create()
+{
+  return std::allocate_shared<PlanarBaseURInvKin>(Eigen::aligned_allocator<PlanarBaseURInvKin>());
+}
+
+bool PlanarBaseURInvKin::init(tesseract_kinematics::ForwardKinematics::ConstPtr fwd_kin, const std::string& name,
+                              const std::vector<std::string>& base_joints, const std::vector<std::string>& arm_joints,
+                              const std::string& arm_base_link, const std::string& arm_tip_link, int base_samples)
+{
+  initialized_ = false;
+  if (fwd_kin == nullptr || base_joints.size() != 3 || arm_joints.size() != 6)
+    return false;
+
+  fwd_kin_ = fwd_kin->clone();
+  name_ = name;
+  joint_names_ = fwd_kin->getJointNames();
+  limits_ = fwd_kin->getLimits();
+  arm_base_link_ = arm_base_link;
+  arm_tip_link_ = arm_tip_link;
+  base_samples_ = base_samples;
+
+  auto getIndex = [this](const std::string& joint_name) -> long {
+    auto joint = std::find(joint_names_.begin(), joint_names_.end(), joint_name);
+    return joint == joint_names_.end() ? -1 : joint - joint_names_.begin();
+  };
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    base_index_[i] = getIndex(base_joints[i]);
+    if (base_index_[i] < 0)
+      return false;
+  }
+  for (std::size_t i = 0; i < 6; ++i)
+  {
+    arm_index_[i] = getIndex(arm_joints[i]);
+    if (arm_index_[i] < 0)
+      return false;
+  }
+
+  auto calcArmPose = [this](const Eigen::VectorXd& joints, Eigen::Isometry3d& pose) {
+    Eigen::Isometry3d base, tip;
+    if (!fwd_kin_->calcFwdKin(base, joints, arm_base_link_) || !fwd_kin_->calcFwdKin(tip, joints, arm_tip_link_))
+      return false;
+    pose = base.inverse() * tip;
+    return true;
+  };
+
+  // every arm joint turns the arm tip about its axis, measured with the other joints at zero
+  Eigen::VectorXd zero = Eigen::VectorXd::Zero(static_cast<long>(joint_names_.size()));
+  if (!calcArmPose(zero, home_))
+    return false;
+  for (std::size_t i = 0; i < 6; ++i)
+  {
+    Eigen::VectorXd joints = zero;
+    joints[arm_index_[i]] = 1;
+    Eigen::Isometry3d moved;
+    if (!calcArmPose(joints, moved))
+      return false;
+
+    Eigen::Isometry3d motion = moved * home_.inverse();
+    Eigen::AngleAxisd rotation(motion.linear());
+    if (std::abs(rotation.angle() - 1) > STRUCTURE_TOLERANCE)
+      return false;
+    axes_[i] = rotation.axis();
+
+    // points on the axis are those the motion leaves in place
+    Eigen::Matrix3d displacement = Eigen::Matrix3d::Identity() - motion.linear();
+    axis_points_[i] = displacement.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeFullV).solve(motion.translation());
+    if ((displacement * axis_points_[i] - motion.translation()).norm() > STRUCTURE_TOLERANCE)
+      return false;
+  }
+
+  if (axes_[1].cross(axes_[2]).norm() > STRUCTURE_TOLERANCE || axes_[1].cross(axes_[3]).norm() > STRUCTURE_TOLERANCE)
+    return false;
+
+  Eigen::Vector3d wrist_normal = axes_[4].cross(axes_[5]);
+  if (wrist_normal.norm() < STRUCTURE_TOLERANCE ||
+      std::abs(wrist_normal.normalized().dot(axis_points_[5] - axis_points_[4])) > STRUCTURE_TOLERANCE)
+    return false;
+  Eigen::Matrix<double, 3, 2> wrist_axes;
+  wrist_axes << axes_[4], -axes_[5];
+  Eigen::Vector2d wrist_offsets = wrist_axes.colPivHouseholderQr().solve(axis_points_[5] - axis_points_[4]);
+  wrist_point_ = axis_points_[4] + wrist_offsets[0] * axes_[4];
+
+  // the base joints place the arm base this far from their own position, the links add at most their lengths
+  Eigen::Isometry3d arm_base;
+  if (!fwd_kin_->calcFwdKin(arm_base, zero, arm_base_link_))
+    return false;
+  reach_ = arm_base.translation().head<2>().norm() + axis_points_[1].norm() +
+           (axis_points_[2] - axis_points_[1]).norm() + (axis_points_[3] - axis_points_[2]).norm() +
+           (wrist_point_ - axis_points_[3]).norm() + (home_.translation() - wrist_point_).norm();
+
+  initialized_ = true;
+  return true;
+}
+
+Eigen::Isometry3d PlanarBaseURInvKin::calcArmFwdKin(const double* arm_values) const
+{
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  for (std::size_t i = 0; i < 6; ++i)
+    pose = pose * rotationAbout(axes_[i], axis_points_[i], arm_values[i]);
+  return pose * home_;
+}
+
+bool PlanarBaseURInvKin::wrapToLimits(int joint, double seed_value, double& value) const
+{
+  double lower = limits_(arm_index_[joint], 0);
+  double upper = limits_(arm_index_[joint], 1);
+  double closest = seed_value + std::remainder(value - seed_value, 2 * M_PI);
+  bool found = false;
+  for (double turns = -2; turns <= 2; ++turns)
+  {
+    double candidate = closest + turns * 2 * M_PI;
+    if (candidate >= lower && candidate <= upper &&
+        (!found || std::abs(candidate - seed_value) < std::abs(value - seed_value)))
+    {
+      value = candidate;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void PlanarBaseURInvKin::solveArm(const Eigen::Isometry3d& arm_target, const Eigen::VectorXd& joints,
+                                  std::vector<Eigen::VectorXd>& solutions) const
+{
+  Eigen::Isometry3d arm_base;
+  if (!fwd_kin_->calcFwdKin(arm_base, joints, arm_base_link_))
+    return;
+
+  // product of the six joint motions taking the arm from zero to the target
+  Eigen::Isometry3d target = arm_base.inverse() * arm_target;
+  Eigen::Isometry3d motion = target * home_.inverse();
+  const Eigen::Vector3d* w = axes_;
+  const Eigen::Vector3d* p = axis_points_;
+
+  // joints 5 and 6 leave the wrist point in place and joints 2 to 4 keep its height along their axes,
+  // so the shoulder is the turn of joint 1 that brings the wrist point of the target to that height
+  Eigen::Vector3d wrist = motion * wrist_point_ - p[0];
+  Eigen::Vector3d wrist_normal = wrist - w[0].dot(wrist) * w[0];
+  for (double q1 : solveCosSin(wrist_normal.dot(w[1]), -w[0].cross(wrist_normal).dot(w[1]),
+                               w[1].dot(wrist_point_ - p[0]) - w[0].dot(wrist) * w[0].dot(w[1])))
+  {
+    // likewise for the direction of axis 6, which only joint 5 turns out of that height
+    Eigen::Matrix3d rotation = Eigen::AngleAxisd(-q1, w[0]) * motion.linear();
+    double wrist_cos = w[4].dot(w[5]);
+    Eigen::Vector3d axis6_normal = w[5] - wrist_cos * w[4];
+    for (double q5 : solveCosSin(axis6_normal.dot(w[1]), w[4].cross(axis6_normal).dot(w[1]),
+                                 w[1].dot(rotation * w[5]) - wrist_cos * w[4].dot(w[1])))
+    {
+      // joint 6 turns the parallel axis into place, at a wrist singularity it keeps its seed
+      double q6 = joints[arm_index_[5]];
+      solveRotation(w[5], rotation.transpose() * w[1], Eigen::AngleAxisd(-q5, w[4]) * w[1], q6);
+
+      // joints 2 to 4 are a planar arm, the elbow sets the distance of axis 4 from axis 2
+      Eigen::Isometry3d planar = rotationAbout(w[0], p[0], q1).inverse() * motion *
+                                 rotationAbout(w[5], p[5], q6).inverse() * rotationAbout(w[4], p[4], q5).inverse();
+      Eigen::Vector3d axis4 = planar * p[3];
+      Eigen::Vector3d forearm = p[3] - p[2] - w[2].dot(p[3] - p[2]) * w[2];
+      Eigen::Vector3d upper_arm = p[1] - p[2] - w[2].dot(p[1] - p[2]) * w[2];
+      double height = w[2].dot(p[3] - p[1]);
+      double distance_2 = (axis4 - p[1]).squaredNorm() - height * height;
+      if (forearm.norm() < 1e-9 || upper_arm.norm() < 1e-9)
+        continue;
+      double elbow_cos = (forearm.squaredNorm() + upper_arm.squaredNorm() - distance_2) /
+                         (2 * forearm.norm() * upper_arm.norm());
+      double elbow_phase = std::atan2(w[2].dot(forearm.cross(upper_arm)), forearm.dot(upper_arm));
+      for (double q3 : solveCosSin(std::cos(elbow_phase), std::sin(elbow_phase), elbow_cos))
+      {
+        double q2 = joints[arm_index_[1]];
+        solveRotation(w[1], rotationAbout(w[2], p[2], q3) * p[3] - p[1], axis4 - p[1], q2);
+
+        Eigen::Matrix3d wrist_rotation =
+            (Eigen::AngleAxisd(q2, w[1]) * Eigen::AngleAxisd(q3, w[2])).toRotationMatrix().transpose() *
+            planar.linear();
+        Eigen::Vector3d normal = w[3].unitOrthogonal();
+        double q4 = joints[arm_index_[3]];
+        solveRotation(w[3], normal, wrist_rotation * normal, q4);
+
+        double arm_values[6] = { q1, q2, q3, q4, q5, q6 };
+        Eigen::Isometry3d reached = calcArmFwdKin(arm_values);
+        if ((reached.translation() - target.translation()).norm() > SOLUTION_TOLERANCE ||
+            (reached.linear() - target.linear()).norm() > SOLUTION_TOLERANCE)
+          continue;
+
+        Eigen::VectorXd solution = joints;
+        bool within_limits = true;
+        for (int i = 0; i < 6 && within_limits; ++i)
+        {
+          within_limits = wrapToLimits(i, joints[arm_index_[i]], arm_values[i]);
+          solution[arm_index_[i]] = arm_values[i];
+        }
+        if (within_limits)
+          solutions.push_back(solution);
+      }
+    }
+  }
+}
+
+bool PlanarBaseURInvKin::calcInvKin(Eigen::VectorXd& solutions, const Eigen::Isometry3d& pose,
+                                    const Eigen::Ref<const Eigen::VectorXd>& seed) const
+{
+  if (!initialized_ || seed.size() != limits_.rows())
+    return false;
+
+  // joints of attached objects only move links beyond the arm tip
+  Eigen::VectorXd joints = seed;
+  Eigen::Isometry3d arm_tip, chain_tip;
+  if (!fwd_kin_->calcFwdKin(arm_tip, joints, arm_tip_link_) || !fwd_kin_->calcFwdKin(chain_tip, joints))
+    return false;
+  Eigen::Isometry3d arm_target = pose * (arm_tip.inverse() * chain_tip).inverse();
+
+  std::vector<Eigen::VectorXd> found;
+  solveArm(arm_target, joints, found);
+
+  // base poses around the target, uniform over the disc the arm reaches
+  std::uniform_real_distribution<double> unit(0, 1);
+  for (int i = 0; found.empty() && i < base_samples_; ++i)
+  {
+    double radius = reach_ * std::sqrt(unit(rng_));
+    double angle = 2 * M_PI * unit(rng_);
+    joints[base_index_[0]] = arm_target.translation().x() + radius * std::cos(angle);
+    joints[base_index_[1]] = arm_target.translation().y() + radius * std::sin(angle);
+    joints[base_index_[2]] = limits_(base_index_[2], 0) +
+                             unit(rng_) * (limits_(base_index_[2], 1) - limits_(base_index_[2], 0));
+
+    bool base_within_limits = true;
+    for (long index : base_index_)
+      base_within_limits &= joints[index] >= limits_(index, 0) && joints[index] <= limits_(index, 1);
+    if (base_within_limits)
+      solveArm(arm_target, joints, found);
+  }
+  if (found.empty())
+    return false;
+
+  std::sort(found.begin(), found.end(), [&seed](const Eigen::VectorXd& a, const Eigen::VectorXd& b) {
+    return (a - seed).squaredNorm() < (b - seed).squaredNorm();
+  });
+  long n_joints = limits_.rows();
+  solutions.resize(static_cast<long>(found.size()) * n_joints);
+  for (std::size_t i = 0; i < found.size(); ++i)
+    solutions.segment(static_cast<long>(i) * n_joints, n_joints) = found[i];
+  return true;
+}
+
+bool PlanarBaseURInvKin::calcInvKin(Eigen::VectorXd& solutions, const Eigen::Isometry3d& pose,
+                                    const Eigen::Ref<const Eigen::VectorXd>& seed, const std::string& link_name) const
+{
+  if (link_name != getTipLinkName())
+    return false;
+  return calcInvKin(solutions, pose, seed);
+}
+
+bool PlanarBaseURInvKin::checkJoints(const Eigen::Ref<const Eigen::VectorXd>& vec) const
+{
+  if (vec.size() != limits_.rows())
+    return false;
+  for (long i = 0; i < vec.size(); ++i)
+  {
+    if (vec[i] < limits_(i, 0) || vec[i] > limits_(i, 1))
+      return false;
+  }
+  return true;
+}
+
+const std::vector<std::string>& PlanarBaseURInvKin::getJointNames() const
+{
+  return joint_names_;
+}
+
+const std::vector<std::string>& PlanarBaseURInvKin::getLinkNames() const
+{
+  return fwd_kin_->getLinkNames();
+}
+
+const std::vector<std::string>& PlanarBaseURInvKin::getActiveLinkNames() const
+{
+  return fwd_kin_->getActiveLinkNames();
+}
+
+const Eigen::MatrixX2d& PlanarBaseURInvKin::getLimits() const
+{
+  return limits_;
+}
+
+tesseract_scene_graph::SceneGraph::ConstPtr PlanarBaseURInvKin::getSceneGraph() const
+{
+  return fwd_kin_->getSceneGraph();
+}
+
+unsigned int PlanarBaseURInvKin::numJoints() const
+{
+  return static_cast<unsigned int>(joint_names_.size());
+}
+
+const std::string& PlanarBaseURInvKin::getBaseLinkName() const
+{
+  return fwd_kin_->getBaseLinkName();
+}
+
+const std::string& PlanarBaseURInvKin::getTipLinkName() const
+{
+  return fwd_kin_->getTipLinkName();
+}
+
+const std::string& PlanarBaseURInvKin::getName() const
+{
+  return name_;
+}
+
+const std::string& PlanarBaseURInvKin::getSolverName() const
+{
+  return solver_name_;
+}
+
+tesseract_kinematics::InverseKinematics::Ptr PlanarBaseURInvKin::clone() const
+{
+  Ptr cloned = create();
+  cloned->initialized_ = initialized_;
+  cloned->fwd_kin_ = fwd_kin_ != nullptr ? fwd_kin_->clone() : nullptr;
+  cloned->name_ = name_;
+  cloned->joint_names_ = joint_names_;
+  cloned->limits_ = limits_;
+  std::copy(base_index_, base_index_ + 3, cloned->base_index_);
+  std::copy(arm_index_, arm_index_ + 6, cloned->arm_index_);
+  cloned->arm_base_link_ = arm_base_link_;
+  cloned->arm_tip_link_ = arm_tip_link_;
+  std::copy(axes_, axes_ + 6, cloned->axes_);
+  std::copy(axis_points_, axis_points_ + 6, cloned->axis_points_);
+  cloned->wrist_point_ = wrist_point_;
+  cloned->home_ = home_;
+  cloned->reach_ = reach_;
+  cloned->base_samples_ = base_samples_;
+
+  // clones searching in parallel sample different base poses
+  cloned->rng_.seed(rng_());
+  return cloned;
+}
+
+}  // namespace vkc
@@ -1,6 +1,8 @@
 #include <vkc/planner/prob_generator.h>
 #include <vkc/planner/traj_init.h>
 
+#include <limits>
+
 using namespace trajopt;
 using namespace tesseract;
 using namespace tesseract_environment;
@@ -10,12 +12,109 @@ using namespace tesseract_rosutils;
 
 namespace vkc
 {
-ProbGenerator::ProbGenerator()
+ProbGenerator::ProbGenerator() : traj_init_stats_(nullptr)
+{
+}
+
+ProbGenerator::~ProbGenerator()
+{
+  saveIKCache();
+}
+
+void ProbGenerator::setTrajInitOptions(const TrajInitOptions &options)
+{
+  if (!options.reachability_map_file.empty() && !reachability_map_.load(options.reachability_map_file))
+    ROS_WARN("Ignoring inverse reachability map %s, it cannot be read.", options.reachability_map_file.c_str());
+  traj_init_options_ = options;
+}
+
+const TrajInitOptions &ProbGenerator::getTrajInitOptions() const
+{
+  return traj_init_options_;
+}
+
+void ProbGenerator::setTrajInitStats(TrajInitStats *stats)
+{
+  traj_init_stats_ = stats;
+}
+
+bool ProbGenerator::saveIKCache()
+{
+  if (ik_solution_cache_.save())
+    return true;
+  ROS_WARN("Unable to store inverse kinematics solutions.");
+  return false;
+}
+
+void ProbGenerator::setInputGrid(const nav_msgs::OccupancyGrid &grid)
+{
+  input_grid_ = grid;
+}
+
+const nav_msgs::OccupancyGrid &ProbGenerator::getBaseGrid() const
+{
+  return base_grid_;
+}
+
+MapInfo ProbGenerator::fitBaseMap(VKCEnvBasic &env, double max_step)
+{
+  if (!input_grid_.data.empty())
+    return fromMapMetaData(input_grid_.info);
+
+  std::vector<std::string> robot_links =
+      env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver("vkc")->getLinkNames();
+  return fitMapInfo(*env.getVKCEnv()->getTesseract()->getEnvironmentConst(), robot_links, 0.025, max_step);
+}
+
+std::vector<FloorShape> ProbGenerator::getSweptShapes(VKCEnvBasic &env,
+                                                      const std::vector<JointDesiredPose> &joint_objectives)
+{
+  std::vector<FloorShape> shapes;
+  JointSweepRegions::ConstPtr sweep_regions = env.getJointSweepRegions();
+  if (sweep_regions == nullptr)
+    return shapes;
+
+  Environment::ConstPtr environment = env.getVKCEnv()->getTesseract()->getEnvironmentConst();
+  EnvState::ConstPtr current_state = environment->getCurrentState();
+  for (const auto &joint_obj : joint_objectives)
+  {
+    if (!sweep_regions->hasJoint(joint_obj.joint_name))
+      continue;
+
+    // without a current position the whole range may be swept
+    auto joint = current_state->joints.find(joint_obj.joint_name);
+    double from = joint != current_state->joints.end() ? joint->second : -std::numeric_limits<double>::max();
+    if (!sweep_regions->getSweptShapes(*environment, joint_obj.joint_name, from, joint_obj.joint_angle, shapes))
+      ROS_DEBUG("Joint %s moved with its parent, its precomputed sweep is ignored.", joint_obj.joint_name.c_str());
+  }
+  return shapes;
+}
+
+TrajInitContext ProbGenerator::getTrajInitContext(const std::vector<FloorShape> *swept_shapes)
 {
+  TrajInitContext context;
+  context.base_grid = &base_grid_;
+  context.input_grid = &input_grid_;
+  context.grid_cache = &base_grid_cache_;
+  context.ik_cache = &ik_solution_cache_;
+  context.reachability_map = &reachability_map_;
+  context.swept_shapes = swept_shapes;
+  context.stats = traj_init_stats_;
+  return context;
 }
 
 TrajOptProb::Ptr ProbGenerator::genProb(VKCEnvBasic &env, ActionBase::Ptr action, int n_steps)
 {
+  // the static layers are first used by the grids of this problem, so the storage is in place for them
+  StaticBaseLayer::Ptr static_layer = env.getStaticBaseLayer();
+  if (static_layer != nullptr)
+    static_layer->setStorageDirectory(traj_init_options_.grid_storage);
+
+  // the static geometry identifies the scene, without it solutions are not stored
+  const std::string &ik_cache_file = traj_init_options_.ik_cache_file;
+  if (!ik_solution_cache_.setStorageFile(ik_cache_file, static_layer != nullptr ? static_layer->getGeometryHash() : 0))
+    ROS_WARN("Ignoring inverse kinematics cache %s, it cannot be read.", ik_cache_file.c_str());
+
   switch (action->getActionType())
   {
     case ActionType::PickAction:
@@ -130,7 +229,8 @@ TrajOptProb::Ptr ProbGenerator::genPickProb(VKCEnvBasic &env, PickAction::Ptr ac
   if (attach_location_ptr->link_name_.find("marker") == std::string::npos)
   {
     pci.init_info.type = InitInfo::GIVEN_TRAJ;
-    pci.init_info.data = initTrajectory(env, link_objs, joint_objs, MapInfo(12, 12, 0.1), pci.init_info.data, n_steps);
+    pci.init_info.data = initTrajectory(env, link_objs, joint_objs, fitBaseMap(env, 0.1), pci.init_info.data, n_steps,
+                                        traj_init_options_, getTrajInitContext());
     for (int k = 2; k < n_steps; k++)
     {
       pci.init_info.data.row(k).rightCols(6) = pci.init_info.data.row(1).rightCols(6);
@@ -178,6 +278,8 @@ TrajOptProb::Ptr ProbGenerator::genPlaceProb(VKCEnvBasic &env, PlaceAction::Ptr
   addCollisionTerm(pci, 0.0001, 10);  
   
   BaseObject::AttachLocation::Ptr detach_location_ptr = env.getAttachLocation(act->getDetachedObject());
+  // the base has to keep out of the way of the doors and drawers the action moves
+  std::vector<FloorShape> swept_shapes = getSweptShapes(env, act->getJointObjectives());
   if (detach_location_ptr->fixed_base)
   {
     for (int i = 0; i < pci.basic_info.n_steps; ++i)
@@ -253,8 +355,8 @@ TrajOptProb::Ptr ProbGenerator::genPlaceProb(VKCEnvBasic &env, PlaceAction::Ptr
   if (detach_location_ptr->link_name_.find("cabinet") != std::string::npos || detach_location_ptr->link_name_.find("dishwasher") != std::string::npos)
   {
     // pci.init_info.type = InitInfo::GIVEN_TRAJ;
-    initTrajectory(env, act->getLinkObjectives(), act->getJointObjectives(), MapInfo(12, 12, 0.05),
-                                        pci.init_info.data, n_steps);
+    initTrajectory(env, act->getLinkObjectives(), act->getJointObjectives(), fitBaseMap(env, 0.05),
+                   pci.init_info.data, n_steps, traj_init_options_, getTrajInitContext(&swept_shapes));
     Eigen::VectorXd end_pos;
     end_pos.resize(pci.kin->numJoints());
     end_pos.setZero();
@@ -280,8 +382,9 @@ TrajOptProb::Ptr ProbGenerator::genPlaceProb(VKCEnvBasic &env, PlaceAction::Ptr
   else if (detach_location_ptr->connection.parent_link_name.find("stick") == std::string::npos && env.getEndEffectorLink().find("stick") == std::string::npos)
   {
     pci.init_info.type = InitInfo::GIVEN_TRAJ;
-    pci.init_info.data = initTrajectory(env, act->getLinkObjectives(), act->getJointObjectives(), MapInfo(12, 12, 0.05),
-                                      pci.init_info.data, n_steps);
+    pci.init_info.data = initTrajectory(env, act->getLinkObjectives(), act->getJointObjectives(), fitBaseMap(env, 0.05),
+                                      pci.init_info.data, n_steps, traj_init_options_,
+                                      getTrajInitContext(&swept_shapes));
     for (int k = 2; k < n_steps; k++)
     {
       pci.init_info.data.row(k).rightCols(6) = pci.init_info.data.row(1).rightCols(6);
@@ -327,8 +430,8 @@ TrajOptProb::Ptr ProbGenerator::genGotoProb(VKCEnvBasic &env, GotoAction::Ptr ac
   }
 
   pci.init_info.type = InitInfo::GIVEN_TRAJ;
-  pci.init_info.data = initTrajectory(env, act->getLinkObjectives(), act->getJointObjectives(), MapInfo(12, 11, 0.1),
-                                      pci.init_info.data, n_steps);
+  pci.init_info.data = initTrajectory(env, act->getLinkObjectives(), act->getJointObjectives(), fitBaseMap(env, 0.1),
+                                      pci.init_info.data, n_steps, traj_init_options_, getTrajInitContext());
   for (int k = 2; k < n_steps; k++)
   {
     pci.init_info.data.row(k).rightCols(6) = pci.init_info.data.row(1).rightCols(6);
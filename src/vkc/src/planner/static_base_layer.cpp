@@ -0,0 +1,171 @@
+#include <vkc/planner/static_base_layer.h>
+#include <vkc/planner/grid_layer_file.h>
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <ros/console.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+
+#include <sys/stat.h>
+
+namespace vkc
+{
+namespace
+{
+bool makeDirectories(const std::string& directory)
+{
+  for (std::size_t pos = directory.find('/', 1); pos != std::string::npos; pos = directory.find('/', pos + 1))
+  {
+    if (mkdir(directory.substr(0, pos).c_str(), 0755) != 0 && errno != EEXIST)
+      return false;
+  }
+  return mkdir(directory.c_str(), 0755) == 0 || errno == EEXIST;
+}
+}  // namespace
+
+StaticBaseLayer::StaticBaseLayer(const tesseract_environment::Environment& env,
+                                 const std::vector<std::string>& robot_links,
+                                 const std::vector<std::string>& dynamic_links, std::size_t capacity)
+  : dynamic_links_(dynamic_links), capacity_(std::max<std::size_t>(capacity, 1)), geometry_hash_(0)
+{
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = env.getSceneGraph();
+  for (const auto& link : scene_graph->getLinks())
+  {
+    const std::string& link_name = link->getName();
+    if (link->collision.empty() || !scene_graph->getLinkCollisionEnabled(link_name) ||
+        std::find(robot_links.begin(), robot_links.end(), link_name) != robot_links.end() ||
+        std::find(dynamic_links.begin(), dynamic_links.end(), link_name) != dynamic_links.end())
+      continue;
+
+    static_links_.push_back(link_name);
+    static_link_set_.insert(link_name);
+  }
+
+  // static links never move, the layers only change with their geometry and the shape of the base
+  std::vector<std::string> sorted_links = static_links_;
+  std::sort(sorted_links.begin(), sorted_links.end());
+  geometry_hash_ = hashCollisionGeometry(env, sorted_links, { "base_link" });
+}
+
+StaticBaseLayer::CellsPtr StaticBaseLayer::getLayer(const tesseract_environment::Environment& env, const MapInfo& map)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto layer = std::find_if(layers_.begin(), layers_.end(), [&](const Layer& l) { return l.map == map; });
+  if (layer != layers_.end())
+  {
+    layers_.splice(layers_.begin(), layers_, layer);
+    return layers_.front().cells;
+  }
+
+  // layouts that cannot be rasterised are kept as well, so they are not tried again
+  CellsPtr cells = load(map);
+  FloorShape footprint;
+  if (cells == nullptr && getBaseFootprint(env, "base_link", footprint))
+  {
+    bool supported = true;
+    std::vector<FloorShape> shapes;
+    for (const auto& link_name : static_links_)
+    {
+      tesseract_scene_graph::Link::ConstPtr link = env.getSceneGraph()->getLink(link_name);
+      if (link != nullptr && !getLinkFloorShapes(*link, env.getLinkTransform(link_name), shapes))
+        supported = false;
+    }
+
+    if (supported)
+    {
+      std::vector<std::size_t> blocked;
+      for (const auto& shape : shapes)
+        rasteriseShape(shape, footprint, map, blocked);
+
+      auto rasterised = std::make_shared<std::vector<std::int8_t>>(
+          static_cast<std::size_t>(map.grid_size_x) * static_cast<std::size_t>(map.grid_size_y), 0);
+      for (auto cell : blocked)
+        (*rasterised)[cell] = 100;
+      save(map, *rasterised);
+      cells = CellsPtr(rasterised, rasterised->data());
+    }
+  }
+
+  layers_.push_front(Layer{ map, cells });
+  while (layers_.size() > capacity_)
+    layers_.pop_back();
+  return cells;
+}
+
+void StaticBaseLayer::setStorageDirectory(const std::string& directory)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  storage_directory_ = directory;
+}
+
+bool StaticBaseLayer::isStatic(const std::string& link_name) const
+{
+  return static_link_set_.count(link_name) > 0;
+}
+
+const std::vector<std::string>& StaticBaseLayer::getStaticLinks() const
+{
+  return static_links_;
+}
+
+const std::vector<std::string>& StaticBaseLayer::getDynamicLinks() const
+{
+  return dynamic_links_;
+}
+
+std::uint64_t StaticBaseLayer::getGeometryHash() const
+{
+  return geometry_hash_;
+}
+
+std::string StaticBaseLayer::getStoragePath(const MapInfo& map) const
+{
+  if (storage_directory_.empty() || geometry_hash_ == 0)
+    return std::string();
+
+  // several layouts of one scene are kept side by side
+  char name[128];
+  std::snprintf(name, sizeof(name), "static_layer_%016" PRIx64 "_%dx%d_%.4f_%.4f_%.4f.bin", geometry_hash_,
+                map.grid_size_x, map.grid_size_y, map.step_size, map.origin_x, map.origin_y);
+  return storage_directory_ + "/" + name;
+}
+
+StaticBaseLayer::CellsPtr StaticBaseLayer::load(const MapInfo& map) const
+{
+  std::string path = getStoragePath(map);
+  if (path.empty())
+    return nullptr;
+
+  auto file = std::make_shared<MappedGridLayers>();
+  if (!file->open(path))
+    return nullptr;
+
+  const std::int8_t* occupancy = file->getOccupancy(0);
+  if (occupancy == nullptr || file->getGeometryHash() != geometry_hash_ || !(file->getMapInfo() == map))
+  {
+    ROS_WARN("Ignoring stored static base layer %s, it does not match the scene.", path.c_str());
+    return nullptr;
+  }
+
+  // the cells stay in the mapping, which lives as long as any user of the layer
+  ROS_DEBUG("Static base layer mapped from %s", path.c_str());
+  return CellsPtr(file, occupancy);
+}
+
+void StaticBaseLayer::save(const MapInfo& map, const std::vector<std::int8_t>& cells) const
+{
+  std::string path = getStoragePath(map);
+  if (path.empty())
+    return;
+
+  if (!makeDirectories(storage_directory_) || !writeGridLayers(path, map, geometry_hash_, { &cells }))
+    ROS_WARN("Unable to store static base layer in %s", path.c_str());
+}
+
+}  // namespace vkc
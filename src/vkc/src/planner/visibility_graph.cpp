@@ -0,0 +1,377 @@
+#include <vkc/planner/visibility_graph.h>
+#include <vkc/planner/floor_geometry.h>
+
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <ros/console.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract_geometry/geometries.h>
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+namespace vkc
+{
+namespace
+{
+const double EPSILON = 1e-9;
+
+double cross(const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+{
+  return a.x() * b.y() - a.y() * b.x();
+}
+
+// Move every edge of a counter-clockwise convex polygon outwards by the given distance
+VisibilityGraph::Polygon inflate(const VisibilityGraph::Polygon& polygon, double distance)
+{
+  std::size_t n = polygon.size();
+  VisibilityGraph::Polygon inflated(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const Eigen::Vector2d& prev = polygon[(i + n - 1) % n];
+    const Eigen::Vector2d& curr = polygon[i];
+    const Eigen::Vector2d& next = polygon[(i + 1) % n];
+    Eigen::Vector2d d1 = (curr - prev).normalized();
+    Eigen::Vector2d d2 = (next - curr).normalized();
+    Eigen::Vector2d n1(d1.y(), -d1.x());
+    Eigen::Vector2d n2(d2.y(), -d2.x());
+    // miter join, keeps both adjacent edges at exactly the given distance
+    inflated[i] = curr + distance * (n1 + n2) / (1.0 + n1.dot(n2));
+  }
+  return inflated;
+}
+
+// True if the segment passes through the interior of the convex polygon, touching its boundary is fine
+bool intersectsInterior(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const VisibilityGraph::Polygon& polygon)
+{
+  auto separated = [&](const Eigen::Vector2d& axis) {
+    double p_min = std::numeric_limits<double>::max();
+    double p_max = -std::numeric_limits<double>::max();
+    for (const auto& p : polygon)
+    {
+      p_min = std::min(p_min, axis.dot(p));
+      p_max = std::max(p_max, axis.dot(p));
+    }
+    double s_min = std::min(axis.dot(a), axis.dot(b));
+    double s_max = std::max(axis.dot(a), axis.dot(b));
+    return s_max <= p_min + EPSILON || s_min >= p_max - EPSILON;
+  };
+
+  std::size_t n = polygon.size();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    Eigen::Vector2d edge = (polygon[(i + 1) % n] - polygon[i]).normalized();
+    if (separated(Eigen::Vector2d(edge.y(), -edge.x())))
+      return false;
+  }
+
+  Eigen::Vector2d segment = b - a;
+  if (segment.norm() > EPSILON)
+  {
+    segment.normalize();
+    if (separated(Eigen::Vector2d(segment.y(), -segment.x())))
+      return false;
+  }
+  return true;
+}
+
+bool isInside(const Eigen::Vector2d& point, const VisibilityGraph::Polygon& polygon)
+{
+  std::size_t n = polygon.size();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (cross(polygon[(i + 1) % n] - polygon[i], point - polygon[i]) <= EPSILON)
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+VisibilityGraph::VisibilityGraph(double inflation, double max_height)
+  : requested_inflation_(inflation)
+  , requested_max_height_(max_height)
+  , inflation_(inflation)
+  , max_height_(max_height)
+  , complete_(true)
+{
+}
+
+std::size_t VisibilityGraph::build(const tesseract_environment::Environment& env,
+                                   const std::vector<std::string>& robot_links)
+{
+  clear();
+  complete_ = false;
+
+  inflation_ = requested_inflation_;
+  max_height_ = requested_max_height_;
+  if (inflation_ <= 0 || max_height_ <= 0)
+  {
+    FloorShape footprint;
+    if (!getBaseFootprint(env, "base_link", footprint))
+    {
+      ROS_ERROR("Visibility graph: base_link has no collision geometry to derive the inflation from.");
+      return 0;
+    }
+    if (inflation_ <= 0)
+    {
+      inflation_ = 0;
+      for (const auto& point : footprint.hull)
+        inflation_ = std::max(inflation_, point.norm());
+    }
+    if (max_height_ <= 0)
+      max_height_ = footprint.z_max;
+  }
+
+  complete_ = true;
+  tesseract_scene_graph::SceneGraph::ConstPtr scene_graph = env.getSceneGraph();
+  for (const auto& link : scene_graph->getLinks())
+  {
+    if (std::find(robot_links.begin(), robot_links.end(), link->getName()) != robot_links.end() ||
+        !scene_graph->getLinkCollisionEnabled(link->getName()))
+      continue;
+
+    Eigen::Isometry3d link_tf = env.getLinkTransform(link->getName());
+    for (const auto& collision : link->collision)
+    {
+      if (collision->geometry->getType() != tesseract_geometry::GeometryType::BOX)
+      {
+        // other shapes only matter if they reach into the height band, planes and octrees always may
+        tesseract_scene_graph::Link shape_link(link->getName());
+        shape_link.collision.push_back(collision);
+        std::vector<FloorShape> shapes;
+        bool outside_band = getLinkFloorShapes(shape_link, link_tf, shapes);
+        for (const auto& shape : shapes)
+          outside_band = outside_band && (shape.z_min > max_height_ || shape.z_max < 0);
+        if (!outside_band)
+        {
+          ROS_DEBUG("Visibility graph: link %s has obstacles that are not boxes.", link->getName().c_str());
+          complete_ = false;
+        }
+        continue;
+      }
+
+      auto box = std::static_pointer_cast<const tesseract_geometry::Box>(collision->geometry);
+      Eigen::Isometry3d box_tf = link_tf * collision->origin;
+
+      Polygon footprint;
+      double min_z = std::numeric_limits<double>::max();
+      double max_z = -std::numeric_limits<double>::max();
+      for (int corner = 0; corner < 8; ++corner)
+      {
+        Eigen::Vector3d point = box_tf * Eigen::Vector3d(((corner & 1) ? 0.5 : -0.5) * box->getX(),
+                                                         ((corner & 2) ? 0.5 : -0.5) * box->getY(),
+                                                         ((corner & 4) ? 0.5 : -0.5) * box->getZ());
+        footprint.push_back(point.head<2>());
+        min_z = std::min(min_z, point.z());
+        max_z = std::max(max_z, point.z());
+      }
+
+      // table tops and shelves above the base do not block it
+      if (min_z > max_height_ || max_z < 0)
+        continue;
+
+      addObstacle(footprint);
+    }
+  }
+
+  buildGraph();
+  ROS_INFO("Visibility graph: %lu obstacles, %lu corners", obstacles_.size(), corners_.size());
+  return obstacles_.size();
+}
+
+bool VisibilityGraph::isComplete() const
+{
+  return complete_;
+}
+
+void VisibilityGraph::addObstacle(const Polygon& polygon)
+{
+  Polygon hull = convexHull(polygon);
+  if (hull.size() < 3)
+    return;
+  obstacles_.push_back(inflate(hull, inflation_));
+}
+
+void VisibilityGraph::clear()
+{
+  obstacles_.clear();
+  corners_.clear();
+  valid_corners_.clear();
+  edges_.clear();
+}
+
+void VisibilityGraph::buildGraph()
+{
+  corners_.clear();
+  for (std::size_t i = 0; i < obstacles_.size(); ++i)
+  {
+    for (std::size_t j = 0; j < obstacles_[i].size(); ++j)
+      corners_.push_back(Corner{ obstacles_[i][j], i, j });
+  }
+
+  valid_corners_.assign(corners_.size(), true);
+  for (std::size_t i = 0; i < corners_.size(); ++i)
+  {
+    for (std::size_t k = 0; k < obstacles_.size(); ++k)
+    {
+      if (k != corners_[i].obstacle && isInside(corners_[i].point, obstacles_[k]))
+      {
+        valid_corners_[i] = false;
+        break;
+      }
+    }
+  }
+
+  edges_.assign(corners_.size(), std::vector<Edge>());
+  const std::vector<std::size_t> none;
+  for (std::size_t i = 0; i < corners_.size(); ++i)
+  {
+    if (!valid_corners_[i])
+      continue;
+    for (std::size_t j = i + 1; j < corners_.size(); ++j)
+    {
+      if (!valid_corners_[j] || !isTangent(corners_[i], corners_[j].point) ||
+          !isTangent(corners_[j], corners_[i].point) || !isVisible(corners_[i].point, corners_[j].point, none))
+        continue;
+
+      double cost = (corners_[i].point - corners_[j].point).norm();
+      edges_[i].push_back(Edge{ j, cost });
+      edges_[j].push_back(Edge{ i, cost });
+    }
+  }
+}
+
+bool VisibilityGraph::findPath(const Eigen::Vector2d& start, const Eigen::Vector2d& goal, Polygon& path) const
+{
+  path.clear();
+
+  std::vector<std::size_t> start_obstacles = containingObstacles(start);
+  std::vector<std::size_t> goal_obstacles = containingObstacles(goal);
+  std::vector<std::size_t> both_obstacles = start_obstacles;
+  both_obstacles.insert(both_obstacles.end(), goal_obstacles.begin(), goal_obstacles.end());
+
+  if (isVisible(start, goal, both_obstacles))
+  {
+    path.push_back(start);
+    path.push_back(goal);
+    return true;
+  }
+
+  // corners are nodes [0, n), the start is node n and the goal node n + 1
+  std::size_t n = corners_.size();
+  std::size_t start_node = n;
+  std::size_t goal_node = n + 1;
+
+  std::vector<bool> reaches_goal(n, false);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    reaches_goal[i] = valid_corners_[i] && isTangent(corners_[i], goal) && isVisible(corners_[i].point, goal, goal_obstacles);
+  }
+
+  std::vector<double> cost(n + 2, std::numeric_limits<double>::max());
+  std::vector<std::size_t> parent(n + 2, n + 2);
+  std::vector<bool> closed(n + 2, false);
+  using QueueItem = std::pair<double, std::size_t>;
+  std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> open;
+
+  cost[start_node] = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    if (valid_corners_[i] && isTangent(corners_[i], start) && isVisible(start, corners_[i].point, start_obstacles))
+    {
+      cost[i] = (corners_[i].point - start).norm();
+      parent[i] = start_node;
+      open.push(QueueItem(cost[i] + (goal - corners_[i].point).norm(), i));
+    }
+  }
+
+  while (!open.empty())
+  {
+    std::size_t node = open.top().second;
+    open.pop();
+
+    if (node == goal_node)
+      break;
+
+    // a node may be queued several times, only expand it once
+    if (closed[node])
+      continue;
+    closed[node] = true;
+
+    if (reaches_goal[node])
+    {
+      double new_cost = cost[node] + (goal - corners_[node].point).norm();
+      if (new_cost < cost[goal_node])
+      {
+        cost[goal_node] = new_cost;
+        parent[goal_node] = node;
+        open.push(QueueItem(new_cost, goal_node));
+      }
+    }
+
+    for (const auto& edge : edges_[node])
+    {
+      double new_cost = cost[node] + edge.cost;
+      if (new_cost < cost[edge.to])
+      {
+        cost[edge.to] = new_cost;
+        parent[edge.to] = node;
+        open.push(QueueItem(new_cost + (goal - corners_[edge.to].point).norm(), edge.to));
+      }
+    }
+  }
+
+  if (parent[goal_node] > n)
+    return false;
+
+  for (std::size_t node = goal_node; node != start_node; node = parent[node])
+    path.push_back(node == goal_node ? goal : corners_[node].point);
+  path.push_back(start);
+  std::reverse(path.begin(), path.end());
+  return true;
+}
+
+const std::vector<VisibilityGraph::Polygon>& VisibilityGraph::getObstacles() const
+{
+  return obstacles_;
+}
+
+bool VisibilityGraph::isVisible(const Eigen::Vector2d& a, const Eigen::Vector2d& b,
+                                const std::vector<std::size_t>& ignored) const
+{
+  for (std::size_t k = 0; k < obstacles_.size(); ++k)
+  {
+    if (std::find(ignored.begin(), ignored.end(), k) != ignored.end())
+      continue;
+    if (intersectsInterior(a, b, obstacles_[k]))
+      return false;
+  }
+  return true;
+}
+
+bool VisibilityGraph::isTangent(const Corner& corner, const Eigen::Vector2d& other) const
+{
+  // a shortest path only bends around a corner if it does not cut into the obstacle,
+  // i.e. both neighbouring corners lie on the same side of the line
+  const Polygon& polygon = obstacles_[corner.obstacle];
+  std::size_t n = polygon.size();
+  Eigen::Vector2d direction = other - corner.point;
+  double prev_side = cross(direction, polygon[(corner.index + n - 1) % n] - corner.point);
+  double next_side = cross(direction, polygon[(corner.index + 1) % n] - corner.point);
+  return (prev_side >= -EPSILON && next_side >= -EPSILON) || (prev_side <= EPSILON && next_side <= EPSILON);
+}
+
+std::vector<std::size_t> VisibilityGraph::containingObstacles(const Eigen::Vector2d& point) const
+{
+  std::vector<std::size_t> obstacles;
+  for (std::size_t k = 0; k < obstacles_.size(); ++k)
+  {
+    if (isInside(point, obstacles_[k]))
+      obstacles.push_back(k);
+  }
+  return obstacles;
+}
+
+}  // namespace vkc
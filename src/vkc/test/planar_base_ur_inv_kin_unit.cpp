@@ -0,0 +1,189 @@
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <gtest/gtest.h>
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <tesseract_kinematics/kdl/kdl_fwd_kin_chain.h>
+#include <tesseract_scene_graph/graph.h>
+
+#include <vkc/planner/planar_base_ur_inv_kin.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace vkc;
+using namespace tesseract_scene_graph;
+
+namespace
+{
+const std::vector<std::string> BASE_JOINTS = { "base_y_base_x", "base_theta_base_y", "base_link_base_theta" };
+const std::vector<std::string> ARM_JOINTS = { "ur_arm_shoulder_pan_joint", "ur_arm_shoulder_lift_joint",
+                                              "ur_arm_elbow_joint",        "ur_arm_wrist_1_joint",
+                                              "ur_arm_wrist_2_joint",      "ur_arm_wrist_3_joint" };
+
+void addJoint(SceneGraph& scene_graph, const std::string& name, JointType type, const std::string& parent,
+              const std::string& child, const Eigen::Vector3d& xyz, const Eigen::Vector3d& rpy,
+              const Eigen::Vector3d& axis, double lower, double upper)
+{
+  scene_graph.addLink(Link(child));
+
+  Joint joint(name);
+  joint.type = type;
+  joint.parent_link_name = parent;
+  joint.child_link_name = child;
+  joint.parent_to_joint_origin_transform = Eigen::Isometry3d::Identity();
+  joint.parent_to_joint_origin_transform.translation() = xyz;
+  joint.parent_to_joint_origin_transform.linear() = (Eigen::AngleAxisd(rpy.z(), Eigen::Vector3d::UnitZ()) *
+                                                     Eigen::AngleAxisd(rpy.y(), Eigen::Vector3d::UnitY()) *
+                                                     Eigen::AngleAxisd(rpy.x(), Eigen::Vector3d::UnitX()))
+                                                        .toRotationMatrix();
+  joint.axis = axis;
+  if (type != JointType::FIXED)
+  {
+    joint.limits = std::make_shared<JointLimits>();
+    joint.limits->lower = lower;
+    joint.limits->upper = upper;
+    joint.limits->effort = 100;
+    joint.limits->velocity = 1;
+  }
+  scene_graph.addJoint(joint);
+}
+
+// planar base carrying a UR5e, with the offsets of ur_e_description/urdf/ur5e.urdf.xacro
+SceneGraph::Ptr createPlanarBaseUR5e()
+{
+  auto scene_graph = std::make_shared<SceneGraph>();
+  scene_graph->addLink(Link("world"));
+  scene_graph->setRoot("world");
+
+  Eigen::Vector3d zero = Eigen::Vector3d::Zero();
+  addJoint(*scene_graph, BASE_JOINTS[0], JointType::PRISMATIC, "world", "base_x", zero, zero,
+           Eigen::Vector3d::UnitX(), -10, 10);
+  addJoint(*scene_graph, BASE_JOINTS[1], JointType::PRISMATIC, "base_x", "base_y", zero, zero,
+           Eigen::Vector3d::UnitY(), -10, 10);
+  addJoint(*scene_graph, BASE_JOINTS[2], JointType::REVOLUTE, "base_y", "base_link", zero, zero,
+           Eigen::Vector3d::UnitZ(), -2 * M_PI, 2 * M_PI);
+  addJoint(*scene_graph, "ur_arm_base_link_joint", JointType::FIXED, "base_link", "ur_arm_base_link",
+           Eigen::Vector3d(0.3, 0, 0.4), Eigen::Vector3d(0, 0, M_PI), zero, 0, 0);
+
+  addJoint(*scene_graph, ARM_JOINTS[0], JointType::REVOLUTE, "ur_arm_base_link", "ur_arm_shoulder_link",
+           Eigen::Vector3d(0, 0, 0.163), zero, Eigen::Vector3d::UnitZ(), -2 * M_PI, 2 * M_PI);
+  addJoint(*scene_graph, ARM_JOINTS[1], JointType::REVOLUTE, "ur_arm_shoulder_link", "ur_arm_upper_arm_link",
+           Eigen::Vector3d(0, 0.138, 0), Eigen::Vector3d(0, M_PI / 2, 0), Eigen::Vector3d::UnitY(), -2 * M_PI,
+           2 * M_PI);
+  addJoint(*scene_graph, ARM_JOINTS[2], JointType::REVOLUTE, "ur_arm_upper_arm_link", "ur_arm_forearm_link",
+           Eigen::Vector3d(0, -0.131, 0.425), zero, Eigen::Vector3d::UnitY(), -M_PI, M_PI);
+  addJoint(*scene_graph, ARM_JOINTS[3], JointType::REVOLUTE, "ur_arm_forearm_link", "ur_arm_wrist_1_link",
+           Eigen::Vector3d(0, 0, 0.392), Eigen::Vector3d(0, M_PI / 2, 0), Eigen::Vector3d::UnitY(), -2 * M_PI,
+           2 * M_PI);
+  addJoint(*scene_graph, ARM_JOINTS[4], JointType::REVOLUTE, "ur_arm_wrist_1_link", "ur_arm_wrist_2_link",
+           Eigen::Vector3d(0, 0.127, 0), zero, Eigen::Vector3d::UnitZ(), -2 * M_PI, 2 * M_PI);
+  addJoint(*scene_graph, ARM_JOINTS[5], JointType::REVOLUTE, "ur_arm_wrist_2_link", "ur_arm_wrist_3_link",
+           Eigen::Vector3d(0, 0, 0.1), zero, Eigen::Vector3d::UnitY(), -2 * M_PI, 2 * M_PI);
+  addJoint(*scene_graph, "ur_arm_ee_fixed_joint", JointType::FIXED, "ur_arm_wrist_3_link", "ur_arm_ee_link",
+           Eigen::Vector3d(0, 0.1, 0), Eigen::Vector3d(0, 0, M_PI / 2), zero, 0, 0);
+  return scene_graph;
+}
+
+class PlanarBaseURInvKinUnit : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    auto fwd_kin = std::make_shared<tesseract_kinematics::KDLFwdKinChain>();
+    ASSERT_TRUE(fwd_kin->init(createPlanarBaseUR5e(), "world", "ur_arm_ee_link", "vkc"));
+    fwd_kin_ = fwd_kin;
+
+    inv_kin_ = PlanarBaseURInvKin::create();
+    ASSERT_TRUE(inv_kin_->init(fwd_kin_, "vkc", BASE_JOINTS, ARM_JOINTS, "ur_arm_base_link", "ur_arm_wrist_3_link"));
+    ASSERT_EQ(inv_kin_->numJoints(), 9u);
+  }
+
+  tesseract_kinematics::ForwardKinematics::Ptr fwd_kin_;
+  PlanarBaseURInvKin::Ptr inv_kin_;
+};
+}  // namespace
+
+TEST_F(PlanarBaseURInvKinUnit, RoundTripReturnsAllBranches)  // NOLINT
+{
+  std::minstd_rand rng(42);
+  std::uniform_real_distribution<double> position(-2, 2);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::bernoulli_distribution flip(0.5);
+
+  // a bent elbow keeps the wrist well inside the workspace, where every branch reaches it; with the arm
+  // stretched out, flipping the wrist can move it out of reach and fewer branches exist
+  std::uniform_real_distribution<double> elbow(1.5, 2.2);
+
+  int tested = 0;
+  while (tested < 100)
+  {
+    Eigen::VectorXd joints(9);
+    joints << position(rng), position(rng), angle(rng), angle(rng), angle(rng), (flip(rng) ? -1 : 1) * elbow(rng),
+        angle(rng), angle(rng), angle(rng);
+
+    // at the wrist singularity branches coincide
+    if (std::abs(std::sin(joints[7])) < 0.1)
+      continue;
+    ++tested;
+
+    Eigen::Isometry3d target;
+    ASSERT_TRUE(fwd_kin_->calcFwdKin(target, joints));
+
+    Eigen::VectorXd solutions;
+    ASSERT_TRUE(inv_kin_->calcInvKin(solutions, target, joints));
+    ASSERT_EQ(solutions.size(), 8 * 9);
+
+    // the base of the seed reaches the target, and the joints the target came from are among the branches
+    bool found_joints = false;
+    for (long k = 0; k < 8; ++k)
+    {
+      Eigen::VectorXd solution = solutions.segment(k * 9, 9);
+      EXPECT_TRUE(solution.head<3>().isApprox(joints.head<3>(), 1e-12));
+
+      Eigen::Isometry3d reached;
+      ASSERT_TRUE(fwd_kin_->calcFwdKin(reached, solution));
+      EXPECT_LT((reached.translation() - target.translation()).norm(), 1e-6);
+      EXPECT_LT((reached.linear() - target.linear()).norm(), 1e-6);
+
+      found_joints |= (solution - joints).norm() < 1e-6;
+      for (long other = 0; other < k; ++other)
+        EXPECT_GT((solutions.segment(other * 9, 9) - solution).norm(), 1e-3);
+    }
+    EXPECT_TRUE(found_joints);
+  }
+}
+
+TEST_F(PlanarBaseURInvKinUnit, MovesBaseForTargetsOutOfReach)  // NOLINT
+{
+  Eigen::VectorXd joints = Eigen::VectorXd::Zero(9);
+  joints[4] = -1;
+  joints[5] = 1.5;
+  joints[7] = 1;
+
+  Eigen::Isometry3d target;
+  ASSERT_TRUE(fwd_kin_->calcFwdKin(target, joints));
+
+  // the same arm pose, seeded from a base too far away to reach it
+  Eigen::VectorXd seed = joints;
+  seed[0] = 5;
+  seed[1] = -5;
+  Eigen::VectorXd solutions;
+  ASSERT_TRUE(inv_kin_->calcInvKin(solutions, target, seed));
+  ASSERT_EQ(solutions.size() % 9, 0);
+
+  Eigen::Isometry3d reached;
+  ASSERT_TRUE(fwd_kin_->calcFwdKin(reached, solutions.head(9)));
+  EXPECT_LT((reached.translation() - target.translation()).norm(), 1e-6);
+  EXPECT_LT((reached.linear() - target.linear()).norm(), 1e-6);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
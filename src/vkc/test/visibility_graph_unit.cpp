@@ -0,0 +1,116 @@
+#include <tesseract_common/macros.h>
+TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
+#include <gtest/gtest.h>
+#include <Eigen/Eigen>
+TESSERACT_COMMON_IGNORE_WARNINGS_POP
+
+#include <vkc/planner/visibility_graph.h>
+
+#include <cmath>
+
+using namespace vkc;
+
+namespace
+{
+VisibilityGraph::Polygon box(double min_x, double min_y, double max_x, double max_y)
+{
+  VisibilityGraph::Polygon polygon;
+  polygon.push_back(Eigen::Vector2d(min_x, min_y));
+  polygon.push_back(Eigen::Vector2d(max_x, min_y));
+  polygon.push_back(Eigen::Vector2d(max_x, max_y));
+  polygon.push_back(Eigen::Vector2d(min_x, max_y));
+  return polygon;
+}
+
+double length(const VisibilityGraph::Polygon& path)
+{
+  double total = 0;
+  for (std::size_t i = 1; i < path.size(); ++i)
+    total += (path[i] - path[i - 1]).norm();
+  return total;
+}
+
+// two boxes one above the other, inflated by 0.25 they leave a gap between y = 0.75 and y = 1.25
+class VisibilityGraphUnit : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    graph_.addObstacle(box(-1, -3, 1, 0.5));
+    graph_.addObstacle(box(-1, 1.5, 1, 4));
+    graph_.buildGraph();
+  }
+
+  VisibilityGraph graph_{ 0.25, 1.0 };
+};
+}  // namespace
+
+TEST_F(VisibilityGraphUnit, InflatesBoxesByTheBaseRadius)  // NOLINT
+{
+  ASSERT_EQ(graph_.getObstacles().size(), 2u);
+  const VisibilityGraph::Polygon& lower = graph_.getObstacles()[0];
+  ASSERT_EQ(lower.size(), 4u);
+
+  Eigen::AlignedBox2d bounds;
+  for (const auto& point : lower)
+    bounds.extend(point);
+  EXPECT_TRUE(bounds.min().isApprox(Eigen::Vector2d(-1.25, -3.25)));
+  EXPECT_TRUE(bounds.max().isApprox(Eigen::Vector2d(1.25, 0.75)));
+}
+
+TEST_F(VisibilityGraphUnit, StraightLineThroughTheGap)  // NOLINT
+{
+  VisibilityGraph::Polygon path;
+  ASSERT_TRUE(graph_.findPath(Eigen::Vector2d(-4, 1), Eigen::Vector2d(4, 1), path));
+  ASSERT_EQ(path.size(), 2u);
+  EXPECT_NEAR(length(path), 8, 1e-9);
+}
+
+TEST_F(VisibilityGraphUnit, BendsAroundTheCornersOfTheGap)  // NOLINT
+{
+  // the straight line cuts into the lower box before the gap and into the upper one after it
+  VisibilityGraph::Polygon path;
+  ASSERT_TRUE(graph_.findPath(Eigen::Vector2d(-4, 0), Eigen::Vector2d(4, 2), path));
+  ASSERT_EQ(path.size(), 4u);
+  EXPECT_TRUE(path[0].isApprox(Eigen::Vector2d(-4, 0)));
+  EXPECT_TRUE(path[1].isApprox(Eigen::Vector2d(-1.25, 0.75)));
+  EXPECT_TRUE(path[2].isApprox(Eigen::Vector2d(1.25, 1.25)));
+  EXPECT_TRUE(path[3].isApprox(Eigen::Vector2d(4, 2)));
+  EXPECT_NEAR(length(path), 2 * std::hypot(2.75, 0.75) + std::hypot(2.5, 0.5), 1e-9);
+}
+
+TEST(VisibilityGraph, GoesAroundWhenTheGapIsTooNarrow)  // NOLINT
+{
+  // the inflated boxes overlap, the shortest path passes the upper box on its top
+  VisibilityGraph graph(0.5, 1.0);
+  graph.addObstacle(box(-1, -3, 1, 0.5));
+  graph.addObstacle(box(-1, 1.25, 1, 2));
+  graph.buildGraph();
+
+  VisibilityGraph::Polygon path;
+  ASSERT_TRUE(graph.findPath(Eigen::Vector2d(-4, 1), Eigen::Vector2d(4, 1), path));
+  ASSERT_EQ(path.size(), 4u);
+  EXPECT_TRUE(path[1].isApprox(Eigen::Vector2d(-1.5, 2.5)));
+  EXPECT_TRUE(path[2].isApprox(Eigen::Vector2d(1.5, 2.5)));
+  EXPECT_NEAR(length(path), 2 * std::hypot(2.5, 1.5) + 3, 1e-9);
+}
+
+TEST(VisibilityGraph, UnreachableGoal)  // NOLINT
+{
+  // the goal is walled in by four boxes whose inflation closes the corners
+  VisibilityGraph graph(0.25, 1.0);
+  graph.addObstacle(box(-2, -2, 2, -1.5));
+  graph.addObstacle(box(-2, 1.5, 2, 2));
+  graph.addObstacle(box(-2, -2, -1.5, 2));
+  graph.addObstacle(box(1.5, -2, 2, 2));
+  graph.buildGraph();
+
+  VisibilityGraph::Polygon path;
+  EXPECT_FALSE(graph.findPath(Eigen::Vector2d(-4, 0), Eigen::Vector2d(0, 0), path));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -4,6 +4,7 @@
 #include <tesseract_common/macros.h>
 TESSERACT_COMMON_IGNORE_WARNINGS_PUSH
 #include <ros/ros.h>
+#include <nav_msgs/OccupancyGrid.h>
 #include <trajopt/problem_description.hpp>
 TESSERACT_COMMON_IGNORE_WARNINGS_POP
 
@@ -20,6 +21,7 @@ TESSERACT_COMMON_IGNORE_WARNINGS_POP
 
 #include <vkc/action/actions.h>
 #include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/traj_init_options.h>
 
 class CostInfo
 {
@@ -68,4 +70,20 @@ int saveTrajToFile(const tesseract_common::TrajArray &traj, const std::string fi
 
 std::vector<vkc::JointDesiredPose> getJointHome(std::unordered_map<std::string, double> home_pose);
 
+// Trajectory initialization settings from the private parameters of a node, defaults for those not set
+vkc::TrajInitOptions readTrajInitOptions(const ros::NodeHandle &pnh);
+
+// Wait for the floor grid on the topic named by the private parameter base_map_topic, e.g. from a map server.
+// False if the parameter is empty (default) or no grid arrives within the timeout.
+bool waitForBaseMap(const ros::NodeHandle &pnh, nav_msgs::OccupancyGrid &grid, double timeout = 5.0);
+
+// Fetch the ball with the stick and put it into cabinet0 of the arena scene
+void genPickBallSeq(vkc::ActionSeq &seq);
+
+// Open cabinet0 of the arena scene and close it again
+void genOpenCabinetSeq(vkc::ActionSeq &seq);
+
+// Move the bottle of the urdf scene to the table
+void genVKCDemoDeq(vkc::ActionSeq &seq);
+
 #endif
\ No newline at end of file
@@ -16,11 +16,22 @@ using namespace tesseract_motion_planners;
 using namespace trajopt;
 // using namespace vkc_example;
 
-void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz_enabled, int nruns)
+void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz_enabled, int nruns,
+         const TrajInitOptions &options)
 {
   ProbGenerator prob_generator;
+  prob_generator.setTrajInitOptions(options);
   ROSPlottingPtr plotter;
 
+  // latched, so rviz shows the floor grid of the last problem also when it subscribes later
+  ros::NodeHandle nh;
+  ros::Publisher base_grid_pub = nh.advertise<nav_msgs::OccupancyGrid>("base_grid", 1, true);
+
+  // base paths are searched on an external floor grid if one is given
+  nav_msgs::OccupancyGrid base_map;
+  if (waitForBaseMap(ros::NodeHandle("~"), base_map))
+    prob_generator.setInputGrid(base_map);
+
   CostInfo cost;
   
   vector<vector<string> > joint_names_record;
@@ -45,13 +56,7 @@ void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz
     {
       tries += 1;
       prob_ptr = prob_generator.genProb(env, action, n_steps);
-
-      if ((abs(abs(prob_ptr->GetInitTraj().bottomRows(1)(0)) - 6) < 1e-6 || abs(abs(prob_ptr->GetInitTraj().bottomRows(1)(1)) - 6) < 1e-6) 
-      && env.getEndEffectorLink().find("cabinet")==string::npos){
-        std::cout << prob_ptr->GetInitTraj().bottomRows(1)(0) << " " << prob_ptr->GetInitTraj().bottomRows(1)(1) << std::endl;
-        if (tries < 4)
-          continue;
-      }
+      base_grid_pub.publish(prob_generator.getBaseGrid());
 
       if (rviz_enabled)
       {
@@ -97,93 +102,20 @@ void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz
   }
 }
 
-void genPickBallSeq(ActionSeq &seq, std::unordered_map<std::string, double> home_pose)
-{
-  std::vector<JointDesiredPose> joint_home = getJointHome(home_pose);
-  ActionBase::Ptr action;
-  vector<LinkDesiredPose> link_objectives;
-  vector<JointDesiredPose> joint_objectives;
-  Eigen::Isometry3d destination;
-
-  // pick up the hook
-  action = make_shared<PickAction>("vkc", "attach_stick0_stick_link");
-  seq.push_back(action);
-
-  // use stick to fetch the ball
-  Eigen::Isometry3d tf1;
-  tf1.translation() = Eigen::Vector3d(0.1, 0, 0);
-  tf1.linear() = Eigen::Quaterniond(1, 0, 0, 0).matrix();
-  action = make_shared<UseAction>("vkc", "attach_marker0_marker_link", tf1, "stick0_stick_link");
-  seq.push_back(action);
-
-  // Move the ball out of table
-  link_objectives.clear();
-  joint_objectives.clear();
-  destination.translation() = Eigen::Vector3d(-1, 1.5, 0.1);
-  destination.linear() = Eigen::Quaterniond(1, 0, 0, 0).matrix();
-  link_objectives.push_back(LinkDesiredPose("marker0_base_link", destination));
-  action = make_shared<PlaceAction>("vkc", "attach_marker0_marker_link", link_objectives, joint_objectives);
-  seq.push_back(action);
-
-  //Place hook back to table
-  link_objectives.clear();
-  joint_objectives.clear();
-  destination.translation() = Eigen::Vector3d(2.5, 1, 0.8);
-  destination.linear() = Eigen::Quaterniond(0.7071, 0, 0, -0.7071).matrix();
-  link_objectives.push_back(LinkDesiredPose("stick0_base_link", destination));
-  action = make_shared<PlaceAction>("vkc", "attach_stick0_stick_link", link_objectives, joint_objectives);
-  seq.push_back(action);
-
-  // Pick cabinet handle
-  action = make_shared<PickAction>("vkc", "attach_cabinet0_handle_link");
-  seq.push_back(action);
-
-  // Open cabinet
-  link_objectives.clear();
-  joint_objectives.clear();
-  joint_objectives.push_back(JointDesiredPose("cabinet0_cabinet_door_joint", 1.5));
-  action = make_shared<PlaceAction>("vkc", "attach_cabinet0_handle_link", link_objectives, joint_objectives);
-  seq.push_back(action);
-  
-  // Pick ball
-  action = make_shared<PickAction>("vkc", "attach_marker0_marker_link");
-  seq.push_back(action);
-
-  // Place ball into cabinet
-  link_objectives.clear();
-  joint_objectives.clear();
-  destination.setIdentity();
-  destination.translation() = Eigen::Vector3d(0, -2, 1.1);
-  destination.linear() = Eigen::Quaterniond(0.5, -0.5, 0.5, 0.5).matrix();
-  link_objectives.push_back(LinkDesiredPose("marker0_base_link", destination));
-  action = make_shared<PlaceAction>("vkc", "attach_marker0_marker_link", link_objectives, joint_objectives);
-  seq.push_back(action);
-
-  // Pick cabinet handle
-  action = make_shared<PickAction>("vkc", "attach_cabinet0_handle_link");
-  seq.push_back(action);
-
-  // Close cabinet
-  link_objectives.clear();
-  joint_objectives.clear();
-  joint_objectives.push_back(JointDesiredPose("cabinet0_cabinet_door_joint", 0));
-  action = make_shared<PlaceAction>("vkc", "attach_cabinet0_handle_link", link_objectives, joint_objectives);
-  seq.push_back(action);
-}
-
 int main(int argc, char **argv)
 {
   ros::init(argc, argv, "open_door_env_node");
   ros::NodeHandle pnh("~");
   ros::NodeHandle nh;
 
-  ROS_INFO("Initializaing environment node...");
+  ROS_INFO("Initializing environment node...");
 
   bool plotting = true;
   bool rviz = true;
   int steps = 10;
   int n_iter = 1;
   int nruns = 1;
+  std::string sequence = "pick_ball";
 
   // Get ROS Parameters
   pnh.param("plotting", plotting, plotting);
@@ -191,11 +123,15 @@ int main(int argc, char **argv)
   pnh.param<int>("steps", steps, steps);
   pnh.param<int>("niter", n_iter, n_iter);
   pnh.param<int>("nruns", nruns, nruns);
+  pnh.param<std::string>("sequence", sequence, sequence);
 
   ArenaEnv env(nh, plotting, rviz, steps);
 
   ActionSeq actions;
-  genPickBallSeq(actions, env.getHomePose());
+  if (sequence == "open_cabinet")
+    genOpenCabinetSeq(actions);
+  else
+    genPickBallSeq(actions);
 
-  run(env, actions, steps, n_iter, rviz, nruns);
+  run(env, actions, steps, n_iter, rviz, nruns, readTrajInitOptions(pnh));
 }
@@ -0,0 +1,177 @@
+#include <vkc/env/arena_env.h>
+#include <vkc/env/urdf_scene_env.h>
+#include <vkc/env/vkc_env_basic.h>
+#include <vkc/planner/prob_generator.h>
+#include <vkc/planner/traj_init_stats.h>
+#include <vkc_example/utils.h>
+
+#include <vkc/action/actions.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace vkc;
+using namespace tesseract_motion_planners;
+using namespace trajopt;
+
+// Samples in seconds, one vector per stage of TrajInitStats followed by the whole problem generation
+typedef vector<vector<double> > StageSamples;
+
+const int PROBLEM_STAGE = TrajInitStats::STAGE_COUNT;
+
+/**
+ * Generate the problems of an action sequence nruns times, each run in a freshly loaded scene.
+ * Instead of being optimized, the initial trajectory of each problem is applied to the scene, so that
+ * the next action starts where the seed ends. Scene loading is not timed.
+ * The inverse kinematics candidates checked in all runs and their rejections are summed up in checks.
+ */
+void replay(const function<shared_ptr<VKCEnvBasic>()> &load_env, const function<void(ActionSeq &)> &gen_seq,
+            ProbGenerator &prob_generator, int n_steps, int nruns, StageSamples &samples, TrajInitStats &checks)
+{
+  TrajInitStats stats;
+  checks.reset();
+  prob_generator.setTrajInitStats(&stats);
+  samples.assign(PROBLEM_STAGE + 1, vector<double>());
+
+  vector<string> base_joints({ "base_y_base_x", "base_theta_base_y" });
+  vector<double> base_values({ 0, 0 });
+
+  for (int run = 0; run < nruns; ++run)
+  {
+    shared_ptr<VKCEnvBasic> env = load_env();
+    env->getVKCEnv()->getTesseract()->getEnvironment()->setState(base_joints, base_values);
+
+    ActionSeq actions;
+    gen_seq(actions);
+    for (auto &action : actions)
+    {
+      stats.reset();
+      auto start = chrono::steady_clock::now();
+      TrajOptProb::Ptr prob_ptr = prob_generator.genProb(*env, action, n_steps);
+      chrono::duration<double> elapsed_seconds = chrono::steady_clock::now() - start;
+      if (prob_ptr == nullptr)
+      {
+        ROS_ERROR("Cannot generate the problem of an action, run %d is cut short.", run);
+        break;
+      }
+
+      // actions whose problem is not seeded by initTrajectory only count towards the whole generation
+      if (stats.calls > 0)
+      {
+        for (int stage = 0; stage < TrajInitStats::STAGE_COUNT; ++stage)
+          samples[stage].push_back(stats.seconds[stage]);
+      }
+      checks.candidates += stats.candidates;
+      for (int check = 0; check < TrajInitStats::CHECK_COUNT; ++check)
+        checks.rejections[check] += stats.rejections[check];
+      samples[PROBLEM_STAGE].push_back(elapsed_seconds.count());
+
+      PlannerResponse response;
+      response.joint_trajectory.trajectory = prob_ptr->GetInitTraj();
+      vector<string> joint_names = prob_ptr->GetKin()->getJointNames();
+      env->updateEnv(joint_names, response, action);
+    }
+  }
+
+  prob_generator.setTrajInitStats(nullptr);
+}
+
+// Nearest rank percentile, samples must be sorted
+double percentile(const vector<double> &samples, double p)
+{
+  size_t rank = static_cast<size_t>(ceil(p * static_cast<double>(samples.size())));
+  return samples[max<size_t>(rank, 1) - 1];
+}
+
+void printLatencies(const string &scene, StageSamples samples)
+{
+  printf("\n%s\n", scene.c_str());
+  printf("%-10s %6s %10s %10s %10s\n", "stage", "n", "p50 [ms]", "p95 [ms]", "max [ms]");
+  for (size_t stage = 0; stage < samples.size(); ++stage)
+  {
+    const char *name = static_cast<int>(stage) == PROBLEM_STAGE ? "problem" :
+                                                                  TrajInitStats::getStageName(static_cast<int>(stage));
+    vector<double> &values = samples[stage];
+    if (values.empty())
+    {
+      printf("%-10s %6d %10s %10s %10s\n", name, 0, "-", "-", "-");
+      continue;
+    }
+    sort(values.begin(), values.end());
+    printf("%-10s %6zu %10.2f %10.2f %10.2f\n", name, values.size(), 1000 * percentile(values, 0.5),
+           1000 * percentile(values, 0.95), 1000 * values.back());
+  }
+  fflush(stdout);
+}
+
+// Candidates reaching each check in the order they are run, and the share of those the check rejected
+void printRejections(const TrajInitStats &checks)
+{
+  printf("%-16s %10s %10s %8s\n", "check", "reached", "rejected", "share");
+  long reached = checks.candidates;
+  for (int check = 0; check < TrajInitStats::CHECK_COUNT; ++check)
+  {
+    long rejected = checks.rejections[check];
+    printf("%-16s %10ld %10ld %7.1f%%\n", TrajInitStats::getCheckName(check), reached, rejected,
+           reached > 0 ? 100.0 * static_cast<double>(rejected) / static_cast<double>(reached) : 0.0);
+    reached -= rejected;
+  }
+  printf("%-16s %10ld\n", "valid", reached);
+  fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+  ros::init(argc, argv, "init_traj_benchmark_node");
+  ros::NodeHandle pnh("~");
+
+  ROS_INFO("Initializing benchmark node...");
+
+  int steps = 30;
+  int nruns = 20;
+  bool arena = true;
+  bool urdf_scene = true;
+
+  // Get ROS Parameters
+  pnh.param<int>("steps", steps, steps);
+  pnh.param<int>("nruns", nruns, nruns);
+  pnh.param<bool>("arena", arena, arena);
+  pnh.param<bool>("urdf_scene", urdf_scene, urdf_scene);
+
+  // one prob generator per scene and for all of its runs, so that grids are cached as in the example nodes
+  TrajInitOptions options = readTrajInitOptions(pnh);
+
+  // each scene reads its descriptions from its own namespace, without plotting or rviz
+  if (arena)
+  {
+    ProbGenerator prob_generator;
+    prob_generator.setTrajInitOptions(options);
+    StageSamples samples;
+    TrajInitStats checks;
+    replay([steps]() { return make_shared<ArenaEnv>(ros::NodeHandle("arena"), false, false, steps); },
+           genPickBallSeq, prob_generator, steps, nruns, samples, checks);
+    printLatencies("arena", samples);
+    printRejections(checks);
+  }
+
+  if (urdf_scene)
+  {
+    ProbGenerator prob_generator;
+    prob_generator.setTrajInitOptions(options);
+    StageSamples samples;
+    TrajInitStats checks;
+    replay([steps]() { return make_shared<UrdfSceneEnv>(ros::NodeHandle("urdf_scene"), false, false, steps); },
+           genVKCDemoDeq, prob_generator, steps, nruns, samples, checks);
+    printLatencies("urdf_scene", samples);
+    printRejections(checks);
+  }
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include <vkc/env/arena_env.h>
+#include <vkc/planner/inverse_reachability_map.h>
+
+#include <chrono>
+#include <string>
+
+using namespace std;
+using namespace vkc;
+
+// Builds the inverse reachability map of the arm offline, for TrajInitOptions::reachability_map_file
+int main(int argc, char **argv)
+{
+  ros::init(argc, argv, "reachability_map_node");
+  ros::NodeHandle nh;
+  ros::NodeHandle pnh("~");
+
+  int samples = 200000;
+  double position_step = 0.05;
+  double angle_step = M_PI / 12;
+  std::string group = "arm";
+  std::string file;
+
+  // Get ROS Parameters
+  pnh.param<int>("samples", samples, samples);
+  pnh.param<double>("position_step", position_step, position_step);
+  pnh.param<double>("angle_step", angle_step, angle_step);
+  pnh.param<std::string>("group", group, group);
+  pnh.param<std::string>("file", file, file);
+
+  if (file.empty() || samples <= 0)
+  {
+    ROS_ERROR("A map file and a positive number of samples are required.");
+    return 1;
+  }
+
+  ArenaEnv env(nh, false, false, 1);
+  tesseract_kinematics::ForwardKinematics::ConstPtr arm_kin =
+      env.getVKCEnv()->getTesseract()->getFwdKinematicsManagerConst()->getFwdKinematicSolver(group);
+  if (arm_kin == nullptr)
+  {
+    ROS_ERROR("Group %s from the base link to the end effector is not defined.", group.c_str());
+    return 1;
+  }
+
+  ROS_INFO("Sampling %d configurations of %s...", samples, group.c_str());
+  auto start = std::chrono::steady_clock::now();
+  InverseReachabilityMap reachability_map;
+  if (!reachability_map.build(*arm_kin, static_cast<std::size_t>(samples), position_step, angle_step))
+  {
+    ROS_ERROR("No configuration of %s has a non singular jacobian.", group.c_str());
+    return 1;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (!reachability_map.save(file))
+  {
+    ROS_ERROR("Unable to write inverse reachability map %s.", file.c_str());
+    return 1;
+  }
+  ROS_INFO("Inverse reachability map of %s to %s built in %.1f s, written to %s.",
+           reachability_map.getBaseLinkName().c_str(), reachability_map.getTipLinkName().c_str(), seconds,
+           file.c_str());
+  return 0;
+}
@@ -16,11 +16,22 @@ using namespace tesseract_motion_planners;
 using namespace trajopt;
 // using namespace vkc_example;
 
-void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz_enabled)
+void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz_enabled,
+         const TrajInitOptions &options)
 {
   ProbGenerator prob_generator;
+  prob_generator.setTrajInitOptions(options);
   ROSPlottingPtr plotter;
 
+  // latched, so rviz shows the floor grid of the last problem also when it subscribes later
+  ros::NodeHandle nh;
+  ros::Publisher base_grid_pub = nh.advertise<nav_msgs::OccupancyGrid>("base_grid", 1, true);
+
+  // base paths are searched on an external floor grid if one is given
+  nav_msgs::OccupancyGrid base_map;
+  if (waitForBaseMap(ros::NodeHandle("~"), base_map))
+    prob_generator.setInputGrid(base_map);
+
   vector<vector<string> > joint_names_record;
   vector<PlannerResponse> planner_responses;
 
@@ -48,6 +59,7 @@ void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz
     {
       tries += 1;
       prob_ptr = prob_generator.genProb(env, action, n_steps);
+      base_grid_pub.publish(prob_generator.getBaseGrid());
 
       if (rviz_enabled)
       {
@@ -99,33 +111,13 @@ void run(VKCEnvBasic &env, ActionSeq actions, int n_steps, int n_iter, bool rviz
   }
 }
 
-void genVKCDemoDeq(ActionSeq &seq, std::unordered_map<std::string, double> home_pose)
-{
-  std::vector<JointDesiredPose> joint_home = getJointHome(home_pose);
-  ActionBase::Ptr action;
-  vector<LinkDesiredPose> link_objectives;
-  vector<JointDesiredPose> joint_objectives;
-  Eigen::Isometry3d destination;
-
-  action = make_shared<PickAction>("vkc", "attach_bottle");
-  seq.push_back(action);
-
-  link_objectives.clear();
-  joint_objectives.clear();
-  destination.translation() = Eigen::Vector3d(-1.6, 1.4, 0.9);
-  destination.linear() = Eigen::Quaterniond(0.7071, 0.7071, 0, 0.0).matrix();
-  link_objectives.push_back(LinkDesiredPose("bottle", destination));
-  action = make_shared<PlaceAction>("vkc", "attach_bottle", link_objectives, joint_objectives);
-  seq.push_back(action);
-}
-
 int main(int argc, char **argv)
 {
   ros::init(argc, argv, "urdf_scene_env_node");
   ros::NodeHandle pnh("~");
   ros::NodeHandle nh;
 
-  ROS_INFO("Initializaing environment node...");
+  ROS_INFO("Initializing environment node...");
 
   bool plotting = true;
   bool rviz = true;
@@ -141,7 +133,7 @@ int main(int argc, char **argv)
   UrdfSceneEnv env(nh, plotting, rviz, steps);
 
   ActionSeq actions;
-  genVKCDemoDeq(actions, env.getHomePose());
+  genVKCDemoDeq(actions);
   
-  run(env, actions, steps, n_iter, rviz);
+  run(env, actions, steps, n_iter, rviz, readTrajInitOptions(pnh));
 }
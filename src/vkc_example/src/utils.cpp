@@ -4,6 +4,7 @@ using namespace std;
 using namespace tesseract_rosutils;
 using namespace tesseract_motion_planners;
 using namespace trajopt;
+using namespace vkc;
 
 void solveProb(TrajOptProb::Ptr prob_ptr, PlannerResponse &response, int n_iter)
 {
@@ -126,3 +127,157 @@ std::vector<vkc::JointDesiredPose> getJointHome(std::unordered_map<std::string,
   }
   return joint_home;
 }
+
+vkc::TrajInitOptions readTrajInitOptions(const ros::NodeHandle &pnh)
+{
+  vkc::TrajInitOptions options;
+  pnh.param<int>("grid_threads", options.grid_threads, options.grid_threads);
+  pnh.param<bool>("coarse_to_fine", options.coarse_to_fine, options.coarse_to_fine);
+  pnh.param<bool>("use_base_roadmap", options.use_base_roadmap, options.use_base_roadmap);
+  pnh.param<bool>("use_visibility_graph", options.use_visibility_graph, options.use_visibility_graph);
+  pnh.param<std::string>("grid_storage", options.grid_storage, options.grid_storage);
+  pnh.param<bool>("smooth_base_path", options.smooth_base_path, options.smooth_base_path);
+  pnh.param<double>("shortcut_time", options.shortcut_time, options.shortcut_time);
+  pnh.param<int>("ik_threads", options.ik_threads, options.ik_threads);
+  pnh.param<std::string>("ik_cache_file", options.ik_cache_file, options.ik_cache_file);
+  pnh.param<std::string>("reachability_map", options.reachability_map_file, options.reachability_map_file);
+  return options;
+}
+
+bool waitForBaseMap(const ros::NodeHandle &pnh, nav_msgs::OccupancyGrid &grid, double timeout)
+{
+  std::string topic;
+  pnh.param<std::string>("base_map_topic", topic, topic);
+  if (topic.empty())
+    return false;
+
+  ros::NodeHandle nh;
+  nav_msgs::OccupancyGrid::ConstPtr msg =
+      ros::topic::waitForMessage<nav_msgs::OccupancyGrid>(topic, nh, ros::Duration(timeout));
+  if (msg == nullptr)
+  {
+    ROS_WARN("No floor grid received on %s, building it from the scene.", topic.c_str());
+    return false;
+  }
+  grid = *msg;
+  return true;
+}
+
+void genPickBallSeq(ActionSeq &seq)
+{
+  ActionBase::Ptr action;
+  vector<LinkDesiredPose> link_objectives;
+  vector<JointDesiredPose> joint_objectives;
+  Eigen::Isometry3d destination;
+
+  // pick up the hook
+  action = make_shared<PickAction>("vkc", "attach_stick0_stick_link");
+  seq.push_back(action);
+
+  // use stick to fetch the ball
+  Eigen::Isometry3d tf1;
+  tf1.translation() = Eigen::Vector3d(0.1, 0, 0);
+  tf1.linear() = Eigen::Quaterniond(1, 0, 0, 0).matrix();
+  action = make_shared<UseAction>("vkc", "attach_marker0_marker_link", tf1, "stick0_stick_link");
+  seq.push_back(action);
+
+  // Move the ball out of table
+  link_objectives.clear();
+  joint_objectives.clear();
+  destination.translation() = Eigen::Vector3d(-1, 1.5, 0.1);
+  destination.linear() = Eigen::Quaterniond(1, 0, 0, 0).matrix();
+  link_objectives.push_back(LinkDesiredPose("marker0_base_link", destination));
+  action = make_shared<PlaceAction>("vkc", "attach_marker0_marker_link", link_objectives, joint_objectives);
+  seq.push_back(action);
+
+  //Place hook back to table
+  link_objectives.clear();
+  joint_objectives.clear();
+  destination.translation() = Eigen::Vector3d(2.5, 1, 0.8);
+  destination.linear() = Eigen::Quaterniond(0.7071, 0, 0, -0.7071).matrix();
+  link_objectives.push_back(LinkDesiredPose("stick0_base_link", destination));
+  action = make_shared<PlaceAction>("vkc", "attach_stick0_stick_link", link_objectives, joint_objectives);
+  seq.push_back(action);
+
+  // Pick cabinet handle
+  action = make_shared<PickAction>("vkc", "attach_cabinet0_handle_link");
+  seq.push_back(action);
+
+  // Open cabinet
+  link_objectives.clear();
+  joint_objectives.clear();
+  joint_objectives.push_back(JointDesiredPose("cabinet0_cabinet_door_joint", 1.5));
+  action = make_shared<PlaceAction>("vkc", "attach_cabinet0_handle_link", link_objectives, joint_objectives);
+  seq.push_back(action);
+  
+  // Pick ball
+  action = make_shared<PickAction>("vkc", "attach_marker0_marker_link");
+  seq.push_back(action);
+
+  // Place ball into cabinet
+  link_objectives.clear();
+  joint_objectives.clear();
+  destination.setIdentity();
+  destination.translation() = Eigen::Vector3d(0, -2, 1.1);
+  destination.linear() = Eigen::Quaterniond(0.5, -0.5, 0.5, 0.5).matrix();
+  link_objectives.push_back(LinkDesiredPose("marker0_base_link", destination));
+  action = make_shared<PlaceAction>("vkc", "attach_marker0_marker_link", link_objectives, joint_objectives);
+  seq.push_back(action);
+
+  // Pick cabinet handle
+  action = make_shared<PickAction>("vkc", "attach_cabinet0_handle_link");
+  seq.push_back(action);
+
+  // Close cabinet
+  link_objectives.clear();
+  joint_objectives.clear();
+  joint_objectives.push_back(JointDesiredPose("cabinet0_cabinet_door_joint", 0));
+  action = make_shared<PlaceAction>("vkc", "attach_cabinet0_handle_link", link_objectives, joint_objectives);
+  seq.push_back(action);
+}
+
+// Open cabinet0 and close it again: the base starts next to the door, inside the floor the door sweeps
+void genOpenCabinetSeq(ActionSeq &seq)
+{
+  ActionBase::Ptr action;
+  vector<LinkDesiredPose> link_objectives;
+  vector<JointDesiredPose> joint_objectives;
+
+  // Pick cabinet handle
+  action = make_shared<PickAction>("vkc", "attach_cabinet0_handle_link");
+  seq.push_back(action);
+
+  // Open cabinet
+  joint_objectives.push_back(JointDesiredPose("cabinet0_cabinet_door_joint", 1.5));
+  action = make_shared<PlaceAction>("vkc", "attach_cabinet0_handle_link", link_objectives, joint_objectives);
+  seq.push_back(action);
+
+  // Pick cabinet handle
+  action = make_shared<PickAction>("vkc", "attach_cabinet0_handle_link");
+  seq.push_back(action);
+
+  // Close cabinet
+  joint_objectives.clear();
+  joint_objectives.push_back(JointDesiredPose("cabinet0_cabinet_door_joint", 0));
+  action = make_shared<PlaceAction>("vkc", "attach_cabinet0_handle_link", link_objectives, joint_objectives);
+  seq.push_back(action);
+}
+
+void genVKCDemoDeq(ActionSeq &seq)
+{
+  ActionBase::Ptr action;
+  vector<LinkDesiredPose> link_objectives;
+  vector<JointDesiredPose> joint_objectives;
+  Eigen::Isometry3d destination;
+
+  action = make_shared<PickAction>("vkc", "attach_bottle");
+  seq.push_back(action);
+
+  link_objectives.clear();
+  joint_objectives.clear();
+  destination.translation() = Eigen::Vector3d(-1.6, 1.4, 0.9);
+  destination.linear() = Eigen::Quaterniond(0.7071, 0.7071, 0, 0.0).matrix();
+  link_objectives.push_back(LinkDesiredPose("bottle", destination));
+  action = make_shared<PlaceAction>("vkc", "attach_bottle", link_objectives, joint_objectives);
+  seq.push_back(action);
+}